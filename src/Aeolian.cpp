@@ -0,0 +1,186 @@
+// src/Aeolian.cpp
+#include "Aeolian.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace dune {
+
+namespace {
+
+constexpr int kMaxTravel = 16; // cellules parcourues par une plaque au plus (depot force ensuite)
+constexpr int kShadowLook = 8; // cellules regardees au vent pour la zone d'ombre
+constexpr int kAvalanche = 4;  // pas d'eboulement par plaque
+// trajet (+ arrondi) puis eboulement (+ lecture des voisins)
+static_assert(kMaxTravel + 1 + kAvalanche + 1 <= Aeolian::kReach, "portee des evenements");
+static_assert(kShadowLook + 1 <= Aeolian::kReach, "portee de la zone d'ombre");
+static_assert(2 * Aeolian::kReach <= Aeolian::kTile, "tuiles d'une couleur independantes");
+
+uint64_t mix(uint64_t a, uint64_t b)
+{
+    uint64_t z = a ^ (b + 0x9E3779B97F4A7C15ull + (a << 6) + (a >> 2));
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// splitmix64 : un flux par tuile et par iteration
+struct Rng {
+    uint64_t s;
+    uint64_t next()
+    {
+        uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    float uniform() { return (float)(next() >> 40) * (1.f / 16777216.f); }
+    int below(int n) { return (int)(((next() >> 32) * (uint64_t)n) >> 32); }
+};
+
+struct Field {
+    float* h = nullptr;
+    size_t ld = 0;
+    float* sand = nullptr;   // sable mobile par cellule, W*H
+    int W = 0, H = 0;
+    float slab = 0.f;
+    float reposeX = 0.f, reposeY = 0.f; // denivele max au repos vers un voisin en x / en y
+    float ps = 0.f, pns = 0.f;
+    int hop = 1;
+    // decalages entiers (vent arrondi) : d cellules au vent, t cellules sous le vent
+    int upX[kShadowLook + 1] = {}, upY[kShadowLook + 1] = {};
+    int downX[kMaxTravel + 1] = {}, downY[kMaxTravel + 1] = {};
+    float shadowDrop[kShadowLook + 1] = {};
+
+    float& at(int x, int y) const { return h[(size_t)y*ld + x]; }
+    float& sandAt(int x, int y) const { return sand[(size_t)y*W + x]; }
+    bool fixed(int x, int y) const { return x <= 0 || y <= 0 || x >= W-1 || y >= H-1; }
+
+    // Pente de plus de 15 deg vers une cellule au vent
+    bool shadowed(int x, int y) const
+    {
+        const float hc = at(x, y);
+        for(int d=1; d<=kShadowLook; d++){
+            const int ux = x + upX[d], uy = y + upY[d];
+            if(ux < 0 || uy < 0 || ux >= W || uy >= H) break;
+            if(at(ux, uy) - hc > shadowDrop[d]) return true;
+        }
+        return false;
+    }
+
+    // Eboulement depuis (x,y) : vers le voisin le plus en contrebas tant que
+    // la pente depasse l'angle de repos (sable mobile seulement)
+    void slide(int x, int y) const
+    {
+        static const int dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+        for(int s=0; s<kAvalanche; s++){
+            int best = -1;
+            float bestDrop = 0.f;
+            for(int k=0;k<4;k++){
+                const int nx = x + dx[k], ny = y + dy[k];
+                if(fixed(nx, ny)) continue;
+                const float drop = at(x, y) - at(nx, ny) - (dx[k] ? reposeX : reposeY);
+                if(drop > bestDrop){ bestDrop = drop; best = k; }
+            }
+            if(best < 0) return;
+            const float m = std::min(0.5f * bestDrop, sandAt(x, y));
+            if(m <= 0.f) return;
+            const int nx = x + dx[best], ny = y + dy[best];
+            at(x, y) -= m; sandAt(x, y) -= m;
+            at(nx, ny) += m; sandAt(nx, ny) += m;
+            x = nx; y = ny;
+        }
+    }
+
+    // Un tirage : erosion en (x,y), sauts sous le vent jusqu'au depot
+    void event(int x, int y, Rng& rng) const
+    {
+        if(sandAt(x, y) < slab || shadowed(x, y)) return;
+        at(x, y) -= slab;
+        sandAt(x, y) -= slab;
+        // le creux attire les voisins devenus trop raides
+        const float hc = at(x, y);
+        if(!fixed(x+1, y) && at(x+1, y) - hc > reposeX) slide(x+1, y);
+        if(!fixed(x-1, y) && at(x-1, y) - hc > reposeX) slide(x-1, y);
+        if(!fixed(x, y+1) && at(x, y+1) - hc > reposeY) slide(x, y+1);
+        if(!fixed(x, y-1) && at(x, y-1) - hc > reposeY) slide(x, y-1);
+
+        for(int t=hop; ; t+=hop){
+            const int tx = x + downX[t], ty = y + downY[t];
+            if(fixed(tx, ty)) return; // sorti du chunk : perdu
+            const bool last = t + hop > kMaxTravel;
+            const float p = shadowed(tx, ty) ? 1.f : (sandAt(tx, ty) > 0.f ? ps : pns);
+            if(last || rng.uniform() < p){
+                at(tx, ty) += slab;
+                sandAt(tx, ty) += slab;
+                slide(tx, ty);
+                return;
+            }
+        }
+    }
+};
+
+} // namespace
+
+void Aeolian::run(float* h, size_t ld, int W, int H, float cellX, float cellY,
+                  const Params& P, uint64_t seed, const ForEach& forEach)
+{
+    if(!active(P) || W < 3 || H < 3) return;
+
+    const float pi = 3.14159265358979323846f;
+    const float a = P.rotationDeg * pi / 180.f;
+    std::vector<float> sand((size_t)W*(size_t)H, std::max(0.f, P.aeolianSandDepth));
+
+    Field f;
+    f.h = h; f.ld = ld;
+    f.sand = sand.data();
+    f.W = W; f.H = H;
+    f.slab = P.aeolianSlab;
+    const float tanRepose = std::tan(P.aeolianReposeDeg * pi / 180.f);
+    f.reposeX = tanRepose * cellX;
+    f.reposeY = tanRepose * cellY;
+    f.ps = P.aeolianDepositSand;
+    f.pns = P.aeolianDepositBare;
+    f.hop = std::clamp(P.aeolianHop, 1, kMaxTravel);
+    // vent unitaire en cellules ; un pas de vent = windLen en monde
+    const float wx = std::cos(a), wy = std::sin(a);
+    const float windLen = std::sqrt(wx*wx*cellX*cellX + wy*wy*cellY*cellY);
+    const float tanShadow = std::tan(15.f * pi / 180.f);
+    for(int d=1; d<=kShadowLook; d++){
+        f.upX[d] = (int)std::lround(-wx * d);
+        f.upY[d] = (int)std::lround(-wy * d);
+        f.shadowDrop[d] = tanShadow * windLen * d;
+    }
+    for(int t=1; t<=kMaxTravel; t++){
+        f.downX[t] = (int)std::lround(wx * t);
+        f.downY[t] = (int)std::lround(wy * t);
+    }
+
+    const uint64_t base = mix(seed, (uint64_t)(uint32_t)P.aeolianSeed);
+    std::vector<int> tiles;
+    for(int it=0; it<P.aeolianIterations; it++){
+        const int off = (it & 1) ? kTile/2 : 0;
+        const int ntx = (W + off + kTile - 1) / kTile, nty = (H + off + kTile - 1) / kTile;
+        for(int color=0; color<4; color++){
+            tiles.clear();
+            for(int ty=color>>1; ty<nty; ty+=2)
+                for(int tx=color&1; tx<ntx; tx+=2) tiles.push_back(ty*ntx + tx);
+            forEach((int)tiles.size(), [&](int k){
+                const int tx = tiles[k] % ntx, ty = tiles[k] / ntx;
+                // cellules mobiles de la tuile (bords du chunk exclus)
+                const int x0 = std::max(1, tx*kTile - off), x1 = std::min(W-1, (tx+1)*kTile - off);
+                const int y0 = std::max(1, ty*kTile - off), y1 = std::min(H-1, (ty+1)*kTile - off);
+                if(x0 >= x1 || y0 >= y1) return;
+                Rng rng{mix(mix(base, (uint64_t)it), (uint64_t)tiles[k])};
+                const int w = x1 - x0, n = w * (y1 - y0);
+                for(int e=0; e<n; e++){
+                    const int c = rng.below(n);
+                    f.event(x0 + c % w, y0 + c / w, rng);
+                }
+            });
+        }
+    }
+}
+
+} // namespace dune
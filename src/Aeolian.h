@@ -0,0 +1,44 @@
+// src/Aeolian.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "Params.h"
+
+namespace dune {
+
+// Transport de sable eolien, modele de plaques de Werner (1995). Une plaque
+// de aeolianSlab (hauteur monde) est arrachee a une cellule tiree au hasard,
+// saute de aeolianHop cellules sous le vent et se depose avec la probabilite
+// aeolianDepositSand (cellule ensablee) ou aeolianDepositBare (sol nu),
+// sinon repart. Zone d'ombre (pente de plus de 15 deg vue du vent) : pas
+// d'erosion, depot certain. Au-dela de l'angle de repos le sable s'eboule
+// vers le voisin le plus bas. Vent dans la direction Params::rotationDeg.
+//
+// Cellules decoupees en tuiles kTile x kTile, 4 couleurs (damier 2x2) : deux
+// tuiles d'une meme couleur sont a une tuile l'une de l'autre et un evenement
+// ne lit ni n'ecrit a plus de kReach cellules de sa tuile, donc les tuiles
+// d'une couleur tournent en parallele sans verrou. Grille des tuiles decalee
+// d'une demi-tuile une iteration sur deux. Tirages par tuile (graine, chunk,
+// iteration, tuile) : resultat identique quel que soit le nombre de threads.
+// Bords du chunk fixes (raccord au bit pres) ; le sable qui en sort est perdu.
+class Aeolian {
+public:
+    using ForEach = std::function<void(int, const std::function<void(int)>&)>;
+
+    static constexpr int kTile = 64;
+    static constexpr int kReach = 24;
+
+    static bool active(const Params& P) { return P.aeolianEnabled && P.aeolianIterations > 0; }
+
+    // P.aeolianIterations iterations (une iteration : autant de tirages que
+    // de cellules) sur h, W x H lignes de ld floats ; cellX / cellY : pas
+    // monde entre deux cellules. seed distingue les chunks. forEach(n, fn) :
+    // fn(0..n-1) en parallele (taches sautees si annulation : h incomplet).
+    static void run(float* h, size_t ld, int W, int H, float cellX, float cellY,
+                    const Params& P, uint64_t seed, const ForEach& forEach);
+};
+
+} // namespace dune
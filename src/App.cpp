@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cstdio>
 
 #include "imgui.h"
 #include "backends/imgui_impl_sdl2.h"
@@ -46,8 +47,6 @@ namespace dune
 
         setupImGui_();
 
-        noise_.init(1337);
-
         // Startup config
         if (state_.autoLoadConfigOnStart)
         {
@@ -57,8 +56,7 @@ namespace dune
                 state_.configStatus = "Aucune config startup (ok): " + cfgPath_;
         }
 
-        P_.clampSafety();
-        rebuildAll_(true);
+        requestHeights_(true);
 
         mainLoop_();
 
@@ -88,32 +86,41 @@ namespace dune
         ImGui::StyleColorsDark();
     }
 
-    void App::rebuildAll_(bool /*force*/)
+    void App::requestHeights_(bool rebuild)
     {
         P_.clampSafety();
-        W_ = P_.gridW;
-        H_ = P_.gridH;
-
-        gen_.generateChunkGrid(chunkGrid_, W_, H_, P_);
-        heightChunk00_ = (!chunkGrid_.heights.empty() ? chunkGrid_.heights[0] : std::vector<float>());
-
-        HeightmapIO::buildChunkAtlasRGBA8(chunkGrid_, W_, H_, 2, heightRGBA_, &lastMinH_, &lastMaxH_, &atlasW_, &atlasH_);
-        if (!heightRGBA_.empty())
+        if (rebuild)
         {
-            HeightmapIO::ensureOrUpdateTextureRGBA8(heightTex_, atlasW_, atlasH_, heightRGBA_.data());
+            genW_ = P_.gridW;
+            genH_ = P_.gridH;
         }
+        TerrainWorker::Request req;
+        req.P = P_;
+        req.W = genW_;
+        req.H = genH_;
+        req.step = state_.progressive ? 8 : 1;
+        req.preview = state_.interacting;
+        worker_.submit(req);
     }
 
-    void App::updateHeights_()
+    void App::takeHeights_()
     {
-        P_.clampSafety();
-        gen_.generateChunkGrid(chunkGrid_, W_, H_, P_);
-        heightChunk00_ = (!chunkGrid_.heights.empty() ? chunkGrid_.heights[0] : std::vector<float>());
-
-        HeightmapIO::buildChunkAtlasRGBA8(chunkGrid_, W_, H_, 2, heightRGBA_, &lastMinH_, &lastMaxH_, &atlasW_, &atlasH_);
+        std::unique_ptr<TerrainWorker::Result> r = worker_.take();
+        if (!r)
+            return;
+        // Echange : l'ancienne grille affichee repart au worker comme buffer
+        std::swap(chunkGrid_, r->grid);
+        std::swap(heightRGBA_, r->rgba);
+        W_ = r->W;
+        H_ = r->H;
+        atlasW_ = r->atlasW;
+        atlasH_ = r->atlasH;
+        lastMinH_ = r->minH;
+        lastMaxH_ = r->maxH;
+        worker_.recycle(std::move(r));
         if (!heightRGBA_.empty())
         {
-            HeightmapIO::ensureOrUpdateTextureRGBA8(heightTex_, atlasW_, atlasH_, heightRGBA_.data());
+            HeightmapTexture::ensureOrUpdateRGBA8(heightTex_, atlasW_, atlasH_, heightRGBA_.data());
         }
     }
 
@@ -151,6 +158,19 @@ namespace dune
                 lastX_ = e.motion.x;
                 lastY_ = e.motion.y;
             }
+            // Streaming : WASD deplace la camera monde d'un quart de chunk
+            if (e.type == SDL_KEYDOWN && P_.chunkStreaming && !ImGui::GetIO().WantCaptureKeyboard)
+            {
+                const double dx = 0.25 * P_.terrainWidth, dy = 0.25 * P_.terrainLength;
+                switch (e.key.keysym.sym)
+                {
+                case SDLK_a: P_.camWorldX -= dx; state_.needUpdate = true; break;
+                case SDLK_d: P_.camWorldX += dx; state_.needUpdate = true; break;
+                case SDLK_w: P_.camWorldY -= dy; state_.needUpdate = true; break;
+                case SDLK_s: P_.camWorldY += dy; state_.needUpdate = true; break;
+                default: break;
+                }
+            }
             if (e.type == SDL_MOUSEWHEEL)
             {
                 P_.camZoom -= e.wheel.y * 10.f;
@@ -161,12 +181,19 @@ namespace dune
 
     void App::processExports_()
     {
+        // Export de la grille demandee, en pleine resolution : attend le worker
+        if (state_.requestExportPGM || state_.requestExportPNG || state_.requestExportAllChunksRAW16)
+        {
+            worker_.wait();
+            takeHeights_();
+        }
+
         // Mono chunk (0,0)
         if (state_.requestExportPGM)
         {
             state_.requestExportPGM = false;
             std::string fname = HeightmapIO::makeTimestampedFilename("heightmap_chunk_r0_c0", "pgm");
-            if (!heightChunk00_.empty() && HeightmapIO::exportPGM(heightChunk00_, W_, H_, fname))
+            if (!chunkGrid_.empty() && HeightmapIO::exportPGM(chunkGrid_.chunk(0), fname))
                 state_.lastExportPath = fname;
             else
                 state_.lastExportPath = "Export failed";
@@ -176,7 +203,7 @@ namespace dune
         {
             state_.requestExportPNG = false;
             std::string fname = HeightmapIO::makeTimestampedFilename("heightmap_chunk_r0_c0", "png");
-            if (!heightChunk00_.empty() && HeightmapIO::exportRAW16(heightChunk00_, W_, H_, "heightmap.r16"))
+            if (!chunkGrid_.empty() && HeightmapIO::exportRAW16(chunkGrid_.chunk(0), "heightmap.r16"))
                 state_.lastExportPath = fname;
             else
                 state_.lastExportPath = "Export PNG failed";
@@ -195,6 +222,26 @@ namespace dune
         }
     }
 
+    void App::processNoiseBench_()
+    {
+        if (!state_.requestNoiseBench)
+            return;
+        state_.requestNoiseBench = false;
+
+        // reglages effectifs du bruit principal (ridged : ceux des cretes)
+        std::string report = std::string(P_.ridgedMode ? "ridged " : "fbm ") + std::to_string(P_.noiseOctaves())
+                           + " oct (Msamples/s):";
+        for (int e = 0; e < kNoiseEngineCount; ++e)
+        {
+            auto b = NoiseBackend::create((NoiseEngine)e, 1337);
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "\n  %-13s %7.1f", NoiseBackend::engineName((NoiseEngine)e),
+                          NoiseBackend::benchmark(*b, P_.ridgedMode, P_.noiseOctaves(), P_.noiseLacunarity(), P_.noiseGain()));
+            report += buf;
+        }
+        state_.noiseBenchReport = report;
+    }
+
     void App::mainLoop_()
     {
         while (!quit_)
@@ -205,6 +252,7 @@ namespace dune
             ImGui_ImplSDL2_NewFrame();
             ImGui::NewFrame();
 
+            state_.generating = worker_.busy();
             UI::drawControls(P_, W_, H_, state_, cfgPath_);
             UI::drawHeightmapWindow(P_, state_, (dune::TextureHandle)heightTex_, atlasW_, atlasH_, lastMinH_, lastMaxH_);
 
@@ -214,12 +262,20 @@ namespace dune
             state_.needRebuild = false;
             state_.needUpdate = false;
 
-            if (doRebuild)
-                rebuildAll_(false);
-            else if (doUpdate)
-                updateHeights_();
+            // Apercu pendant le drag ; au relachement, une passe pleine qualite
+            const bool preview = state_.interacting;
+            if (!preview && previewShown_)
+                doUpdate = true;
+
+            if (doRebuild || doUpdate)
+            {
+                requestHeights_(doRebuild);
+                previewShown_ = preview;
+            }
+            takeHeights_();
 
             processExports_();
+            processNoiseBench_();
 
             renderer_.beginFrame();
             renderer_.drawAllChunks(chunkGrid_, W_, H_, P_);
@@ -4,14 +4,15 @@
 #include <SDL2/SDL.h>
 #include <GL/glew.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "Params.h"
-#include "Noise.h"
-#include "TerrainGenerator.h"
+#include "TerrainWorker.h"
 #include "Renderer.h"
 #include "HeightmapIO.h"
+#include "HeightmapTexture.h"
 #include "ConfigKV.h"
 #include "UI.h"
 #include "ChunkGrid.h"
@@ -24,10 +25,11 @@ public:
 
 private:
     void setupImGui_();
-    void rebuildAll_(bool force);
-    void updateHeights_();
+    void requestHeights_(bool rebuild);
+    void takeHeights_();
     void handleEvents_();
     void processExports_();
+    void processNoiseBench_();
     void mainLoop_();
 
 private:
@@ -39,20 +41,21 @@ private:
     // Core
     Params  P_{};
     UiState state_{};
-    Noise   noise_{};
-    TerrainGenerator gen_{noise_};
+    TerrainWorker worker_{};
     Renderer renderer_{};
 
-    // Data
+    // Data : grille affichee (W_ x H_ par chunk) ; genW_/genH_ = taille
+    // demandee, affichee une fois la generation terminee
     int W_ = 128;
     int H_ = 128;
+    int genW_ = 128, genH_ = 128;
     ChunkGrid chunkGrid_{};
-    std::vector<float> heightChunk00_{};
 
     // Heightmap preview atlas
     GLuint heightTex_ = 0;
     std::vector<unsigned char> heightRGBA_{};
     float lastMinH_ = 0.0f, lastMaxH_ = 0.0f;
+    bool previewShown_ = false; // dernier terrain demande en qualite apercu
     int atlasW_ = 0, atlasH_ = 0;
 
     // Input state
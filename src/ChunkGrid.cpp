@@ -0,0 +1,306 @@
+// src/ChunkGrid.cpp
+#include "ChunkGrid.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace dune {
+
+void ChunkGrid::Free::operator()(void* p) const
+{
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* ChunkGrid::allocate_(size_t& bytes, bool huge)
+{
+    bytes = std::max<size_t>(bytes, 1);
+    size_t align = kAlign;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // pages de 2 Mo : bloc aligne et arrondi a la page
+    const size_t kHuge = (size_t)2 << 20;
+    if(huge && bytes >= kHuge){
+        align = kHuge;
+        bytes = (bytes + kHuge - 1) / kHuge * kHuge;
+    }
+#else
+    (void)huge;
+#endif
+
+    void* p = nullptr;
+#if defined(_WIN32)
+    p = _aligned_malloc(bytes, align);
+#else
+    if(posix_memalign(&p, align, bytes) != 0) p = nullptr;
+#endif
+    if(!p) throw std::bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if(align != kAlign) madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    std::memset(p, 0, bytes);
+    return p;
+}
+
+void ChunkGrid::reshape(int newCols, int newRows, int W, int H, const std::vector<int>& from, bool quantized)
+{
+    const size_t n = (size_t)std::max(0, newCols) * (size_t)std::max(0, newRows);
+    W = std::max(0, W);
+    H = std::max(0, H);
+    const size_t stride = ((size_t)W + kLane - 1) / kLane * kLane;
+    const size_t chunkFloats = stride * (size_t)H;
+    const bool sameChunk = (slab_ || qslab_) && W == W_ && H == H_;
+
+    // Sources valides, chacune reprise une fois au plus
+    std::vector<int> src(n, -1);
+    std::vector<char> used(count_, 0);
+    bool keep = false;
+    if(sameChunk){
+        for(size_t d=0;d<n && d<from.size();d++){
+            const int s = from[d];
+            if(s < 0 || (size_t)s >= count_ || used[s]) continue;
+            used[s] = 1;
+            src[d] = s;
+            keep = true;
+        }
+    }
+    std::vector<uint64_t> oldStamps = std::move(stamps);
+    oldStamps.resize(count_, 0);
+    stamps.assign(n, 0);
+    for(size_t d=0;d<n;d++) if(src[d] >= 0) stamps[d] = oldStamps[src[d]];
+    std::vector<std::vector<ChunkMip>> oldMips = std::move(mips_);
+    oldMips.resize(count_);
+    mips_.assign(n, {});
+    for(size_t d=0;d<n;d++) if(src[d] >= 0) mips_[d] = std::move(oldMips[src[d]]);
+
+    cols = newCols;
+    rows = newRows;
+    auto at = [&](float* base, size_t idx){ return base + idx*chunkFloats; };
+    const size_t chunkBytes = chunkFloats * sizeof(float);
+
+    if(quantized){
+        // 16 bits : rien ne bouge (meme forme, chunks repris a leur place) ou
+        // nouveau bloc, chunks repris copies (encodes depuis les floats)
+        const size_t qLane = kAlign / sizeof(uint16_t);
+        const size_t qStride = ((size_t)W + qLane - 1) / qLane * qLane;
+        const size_t qChunk = qStride * (size_t)H;
+        bool inPlace = qslab_ && sameChunk && n == count_;
+        for(size_t d=0;d<n && inPlace;d++) inPlace = src[d] < 0 || (size_t)src[d] == d;
+        if(!inPlace){
+            size_t bytes = n * qChunk * sizeof(uint16_t);
+            std::unique_ptr<uint16_t[], Free> q((uint16_t*)allocate_(bytes, hugePages_));
+            std::vector<float> scale(n, 0.f), offset(n, 0.f);
+            for(size_t d=0;d<n;d++){
+                const int s = src[d];
+                if(s < 0) continue;
+                if(qslab_){
+                    std::memcpy(q.get() + d*qChunk, qslab_.get() + (size_t)s*qChunk, qChunk * sizeof(uint16_t));
+                    scale[d] = qScale_[s];
+                    offset[d] = qOffset_[s];
+                }else{
+                    encode_(ConstChunkView(at(slab_.get(), (size_t)s), W, H, stride), q.get() + d*qChunk, qStride,
+                            scale[d], offset[d]);
+                }
+            }
+            qslab_ = std::move(q);
+            qCapacity_ = bytes / sizeof(uint16_t);
+            qStride_ = qStride;
+            qScale_ = std::move(scale);
+            qOffset_ = std::move(offset);
+        }
+        slab_.reset();
+        capacity_ = 0;
+    }else if(qslab_){
+        // quantifiee -> floats : nouveau bloc float, chunks repris decodes
+        std::unique_ptr<float[], Free> slab;
+        if(n * chunkFloats <= capacity_) slab = std::move(slab_);
+        else{
+            size_t bytes = n * chunkFloats * sizeof(float);
+            slab.reset((float*)allocate_(bytes, hugePages_));
+            capacity_ = bytes / sizeof(float);
+        }
+        for(size_t d=0;d<n;d++){
+            if(src[d] < 0) continue;
+            const ConstChunkView v = chunk(src[d]);
+            float* dst = at(slab.get(), d);
+            for(int y=0;y<H;y++) v.row(y, dst + (size_t)y*stride);
+        }
+        slab_ = std::move(slab);
+        qslab_.reset();
+        qCapacity_ = qStride_ = 0;
+        qScale_.clear();
+        qOffset_.clear();
+    }else if(keep && n == count_){
+        // Permutation sur place : chemins (d <- s <- ...) pris depuis leur
+        // bout (contenu que personne ne relit), puis cycles via un tampon
+        float* base = slab_.get();
+        std::vector<char> needed(n, 0), done(n, 0);
+        for(size_t d=0;d<n;d++) if(src[d] >= 0 && (size_t)src[d] != d) needed[src[d]] = 1;
+        for(size_t d=0;d<n;d++){
+            if(src[d] < 0 || (size_t)src[d] == d || needed[d]) continue;
+            for(size_t cur=d; src[cur] >= 0 && (size_t)src[cur] != cur && !done[cur]; ){
+                const size_t s = (size_t)src[cur];
+                std::memcpy(at(base, cur), at(base, s), chunkBytes);
+                done[cur] = 1;
+                cur = s;
+            }
+        }
+        std::vector<float> tmp;
+        for(size_t d=0;d<n;d++){
+            if(src[d] < 0 || (size_t)src[d] == d || done[d]) continue;
+            tmp.assign(at(base, d), at(base, d) + chunkFloats);
+            for(size_t cur=d;;){
+                const size_t s = (size_t)src[cur];
+                done[cur] = 1;
+                if(s == d){ std::memcpy(at(base, cur), tmp.data(), chunkBytes); break; }
+                std::memcpy(at(base, cur), at(base, s), chunkBytes);
+                cur = s;
+            }
+        }
+    }else if(keep){
+        // autre nombre de chunks : nouveau bloc, chunks repris copies
+        size_t bytes = n * chunkFloats * sizeof(float);
+        std::unique_ptr<float[], Free> slab((float*)allocate_(bytes, hugePages_));
+        for(size_t d=0;d<n;d++)
+            if(src[d] >= 0) std::memcpy(at(slab.get(), d), at(slab_.get(), (size_t)src[d]), chunkBytes);
+        slab_ = std::move(slab);
+        capacity_ = bytes / sizeof(float);
+    }else if(n * chunkFloats > capacity_){
+        slab_.reset();
+        size_t bytes = n * chunkFloats * sizeof(float);
+        slab_.reset((float*)allocate_(bytes, hugePages_));
+        capacity_ = bytes / sizeof(float);
+    }
+
+    count_ = n;
+    W_ = W; H_ = H;
+    stride_ = stride;
+    chunkFloats_ = chunkFloats;
+}
+
+void ChunkGrid::encode_(const ConstChunkView& v, uint16_t* q, size_t qStride, float& scale, float& offset)
+{
+    float mn = 1e30f, mx = -1e30f;
+    for(int y=0;y<v.H;y++){
+        const float* r = v.row(y, nullptr);
+        for(int x=0;x<v.W;x++){ mn = std::min(mn, r[x]); mx = std::max(mx, r[x]); }
+    }
+    scale = mx > mn ? (mx - mn) / 65535.f : 0.f;
+    offset = mn;
+    const float inv = scale > 0.f ? 1.f / scale : 0.f;
+    for(int y=0;y<v.H;y++){
+        const float* r = v.row(y, nullptr);
+        uint16_t* o = q + (size_t)y*qStride;
+        for(int x=0;x<v.W;x++)
+            o[x] = (uint16_t)std::min(65535.f, std::max(0.f, (r[x] - mn) * inv + 0.5f));
+    }
+}
+
+void ChunkGrid::quantizeChunk(int idx, const ConstChunkView& src)
+{
+    if(!qslab_ || !src.data || src.W != W_ || src.H != H_) return;
+    encode_(src, qslab_.get() + (size_t)idx*qStride_*H_, qStride_, qScale_[idx], qOffset_[idx]);
+}
+
+int ChunkGrid::mipCount(int W, int H, int levels)
+{
+    int n = 0;
+    while(n < levels && (W > 1 || H > 1)){
+        W = (W + 1) / 2;
+        H = (H + 1) / 2;
+        n++;
+    }
+    return n;
+}
+
+size_t ChunkGrid::bytes() const
+{
+    size_t b = capacity_ * sizeof(float) + qCapacity_ * sizeof(uint16_t);
+    for(const auto& chain : mips_)
+        for(const ChunkMip& m : chain) b += 3 * m.avg.size() * sizeof(float);
+    return b;
+}
+
+void ChunkGrid::buildMips(int idx, int levels, const ConstChunkView& src)
+{
+    std::vector<ChunkMip>& chain = mips_[idx];
+    chain.clear();
+    levels = mipCount(W_, H_, levels);
+    if(levels <= 0) return;
+
+    // Niveau 1 depuis les hauteurs (2 lignes a la fois), puis chaque niveau
+    // depuis le precedent ; poids = hauteurs couvertes par chaque cellule
+    const ConstChunkView v = src.empty() ? chunk(idx) : src;
+    std::vector<float> tmp0((size_t)W_), tmp1((size_t)W_);
+    for(int l=1;l<=levels;l++){
+        const int pw = l == 1 ? W_ : chain.back().W;
+        const int ph = l == 1 ? H_ : chain.back().H;
+        ChunkMip m;
+        m.W = (pw + 1) / 2;
+        m.H = (ph + 1) / 2;
+        m.mn.resize((size_t)m.W * m.H);
+        m.mx.resize(m.mn.size());
+        m.avg.resize(m.mn.size());
+        const int half = 1 << (l - 1); // cote d'une cellule du niveau l-1
+        auto span = [half](int i, int n){ return (float)std::min(half, n - i*half); };
+        for(int y=0;y<m.H;y++){
+            const int y0 = 2*y, y1 = std::min(2*y + 1, ph - 1);
+            const float *mn0, *mn1, *mx0, *mx1, *av0, *av1;
+            if(l == 1){
+                mn0 = mx0 = av0 = v.row(y0, tmp0.data());
+                mn1 = mx1 = av1 = v.row(y1, tmp1.data());
+            }else{
+                const ChunkMip& p = chain.back();
+                mn0 = &p.mn[(size_t)y0*pw]; mn1 = &p.mn[(size_t)y1*pw];
+                mx0 = &p.mx[(size_t)y0*pw]; mx1 = &p.mx[(size_t)y1*pw];
+                av0 = &p.avg[(size_t)y0*pw]; av1 = &p.avg[(size_t)y1*pw];
+            }
+            const float wy0 = span(y0, H_), wy1 = y1 != y0 ? span(y1, H_) : 0.f;
+            for(int x=0;x<m.W;x++){
+                const int x0 = 2*x, x1 = std::min(2*x + 1, pw - 1);
+                const float wx0 = span(x0, W_), wx1 = x1 != x0 ? span(x1, W_) : 0.f;
+                const size_t k = (size_t)y*m.W + x;
+                m.mn[k] = std::min(std::min(mn0[x0], mn0[x1]), std::min(mn1[x0], mn1[x1]));
+                m.mx[k] = std::max(std::max(mx0[x0], mx0[x1]), std::max(mx1[x0], mx1[x1]));
+                m.avg[k] = (wy0 * (wx0*av0[x0] + wx1*av0[x1]) + wy1 * (wx0*av1[x0] + wx1*av1[x1]))
+                         / ((wy0 + wy1) * (wx0 + wx1));
+            }
+        }
+        chain.push_back(std::move(m));
+    }
+}
+
+ConstChunkView ChunkGrid::mipView(int idx, int level) const
+{
+    if(level <= 0) return chunk(idx);
+    const std::vector<ChunkMip>& chain = mips_[idx];
+    if(level > (int)chain.size()) return ConstChunkView();
+    const ChunkMip& m = chain[level - 1];
+    return ConstChunkView(m.avg.data(), m.W, m.H, (size_t)m.W);
+}
+
+void ChunkGrid::clear()
+{
+    slab_.reset();
+    qslab_.reset();
+    qCapacity_ = qStride_ = 0;
+    qScale_.clear();
+    qOffset_.clear();
+    mips_.clear();
+    capacity_ = count_ = 0;
+    W_ = H_ = 0;
+    stride_ = chunkFloats_ = 0;
+    stamps.clear();
+}
+
+} // namespace dune
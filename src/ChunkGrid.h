@@ -1,17 +1,170 @@
 // src/ChunkGrid.h
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace dune {
 
+// Vue sur les hauteurs d'un chunk : H lignes de W valeurs, la ligne y
+// commence a data + y*stride (stride >= W, en floats)
+struct ChunkView {
+    float* data = nullptr;
+    int W = 0, H = 0;
+    size_t stride = 0;
+
+    ChunkView() = default;
+    ChunkView(float* d, int w, int h, size_t s) : data(d), W(w), H(h), stride(s) {}
+
+    float* row(int y) const { return data + (size_t)y*stride; }
+    float& at(int x, int y) const { return data[(size_t)y*stride + x]; }
+    bool empty() const { return !data || W <= 0 || H <= 0; }
+};
+
+// Vue en lecture seule : floats, ou entiers 16 bits decodes a la volee
+// (h = offset + q*scale, ChunkGrid en stockage quantifie)
+struct ConstChunkView {
+    const float* data = nullptr;
+    const uint16_t* q = nullptr;
+    float scale = 0.f, offset = 0.f;
+    int W = 0, H = 0;
+    size_t stride = 0;  // en elements (floats ou entiers)
+
+    ConstChunkView() = default;
+    ConstChunkView(const float* d, int w, int h, size_t s) : data(d), W(w), H(h), stride(s) {}
+    ConstChunkView(const uint16_t* qd, float sc, float off, int w, int h, size_t s)
+        : q(qd), scale(sc), offset(off), W(w), H(h), stride(s) {}
+    ConstChunkView(const ChunkView& v) : data(v.data), W(v.W), H(v.H), stride(v.stride) {}
+
+    float at(int x, int y) const
+    {
+        const size_t i = (size_t)y*stride + x;
+        return data ? data[i] : offset + (float)q[i]*scale;
+    }
+    // Ligne y en floats : en place, ou decodee dans tmp (W floats)
+    const float* row(int y, float* tmp) const
+    {
+        if(data) return data + (size_t)y*stride;
+        const uint16_t* s = q + (size_t)y*stride;
+        for(int x=0;x<W;x++) tmp[x] = offset + (float)s[x]*scale;
+        return tmp;
+    }
+    bool empty() const { return (!data && !q) || W <= 0 || H <= 0; }
+};
+
+// Buffer dense W*H vu comme un chunk
+inline ConstChunkView viewOf(const std::vector<float>& v, int W, int H)
+{
+    return v.size() == (size_t)W*(size_t)H ? ConstChunkView(v.data(), W, H, (size_t)W) : ConstChunkView();
+}
+
+// Niveau l >= 1 de la pyramide d'un chunk : W x H cellules, la cellule
+// (x,y) couvre le bloc de 2^l x 2^l hauteurs en (x<<l, y<<l), tronque au
+// bord. min / max / moyenne (ponderee par les hauteurs couvertes), denses.
+struct ChunkMip {
+    int W = 0, H = 0;
+    std::vector<float> mn, mx, avg;
+};
+
+// Hauteurs de toute la grille dans un seul bloc aligne (kAlign octets) :
+// chunk apres chunk, lignes de stride() floats (W arrondi a kAlign octets),
+// donc chaque ligne de chaque chunk commence alignee. Non copiable ; le bloc
+// n'est realloue que s'il devient trop petit.
+// Stockage quantifie (reshape(..., true)) : chunks en entiers 16 bits,
+// echelle et offset par chunk (min/max du chunk), sans bloc float ; les
+// chunks recalcules sont encodes un par un (quantizeChunk) depuis des floats
+// de travail du generateur.
+// Pyramide optionnelle par chunk (buildMips), deplacee et invalidee avec
+// le contenu du chunk par reshape / clear.
 struct ChunkGrid {
-    std::vector<std::vector<float>> heights; // size rows*cols, each is W*H
+    static constexpr size_t kAlign = 64;
+    static constexpr size_t kLane = kAlign / sizeof(float);
+
+    // Empreinte du contenu de chaque chunk (0 = inconnu), tenue par
+    // TerrainGenerator : modifier les hauteurs a la main demande de la vider
+    std::vector<uint64_t> stamps;
     int cols = 1;
     int rows = 1;
+    // Position du chunk (0,0) pour l'affichage, en chunks (grille centree :
+    // -(cols-1)/2 ; streaming : relative a la camera)
+    double originX = 0.0, originY = 0.0;
+
+    ChunkGrid() = default;
+    ChunkGrid(ChunkGrid&&) = default;
+    ChunkGrid& operator=(ChunkGrid&&) = default;
 
     static inline int index(int c, int r, int cols){ return r * cols + c; }
-    bool empty() const { return heights.empty() || cols<=0 || rows<=0; }
+    bool empty() const { return count_ == 0 || cols<=0 || rows<=0; }
+
+    // Nouvelle forme : cols x rows chunks de W x H, en floats. Le chunk idx
+    // recoit le contenu de l'ancien chunk from[idx] (empreinte, pyramide) ; -1
+    // (ou from vide) : contenu indefini, empreinte 0. Si W ou H changent,
+    // rien n'est repris. Meme forme : permutation sur place (un chunk de
+    // tampon). quantized : stockage 16 bits, chunks repris copies tels quels
+    // (encodes s'ils etaient en floats), rien a faire si aucun ne bouge ;
+    // sinon floats, chunks 16 bits repris decodes.
+    void reshape(int cols, int rows, int W, int H, const std::vector<int>& from = {}, bool quantized = false);
+    void clear();
+
+    int chunkW() const { return W_; }
+    int chunkH() const { return H_; }
+    size_t stride() const { return stride_; }
+    size_t chunkCount() const { return count_; }
+    // Ecriture (generateur) : floats seulement, vue vide si quantifiee
+    ChunkView writableChunk(int idx)
+    {
+        return slab_ ? ChunkView(slab_.get() + (size_t)idx*chunkFloats_, W_, H_, stride_) : ChunkView();
+    }
+    ConstChunkView chunk(int idx) const
+    {
+        if(qslab_) return ConstChunkView(qslab_.get() + (size_t)idx*qStride_*H_, qScale_[idx], qOffset_[idx], W_, H_, qStride_);
+        return ConstChunkView(slab_.get() + (size_t)idx*chunkFloats_, W_, H_, stride_);
+    }
+    size_t bytes() const;
+
+    // Pyramide du chunk idx : niveaux 1..levels (s'arrete a 1 x 1), calcules
+    // depuis src (W x H), ou vide : les hauteurs actuelles ; 0 : pyramide videe
+    void buildMips(int idx, int levels, const ConstChunkView& src = ConstChunkView());
+    // Nombre de niveaux que buildMips produit pour des chunks W x H
+    static int mipCount(int W, int H, int levels);
+    // Niveaux 1..n du chunk idx (vide : pas de pyramide)
+    const std::vector<ChunkMip>& mips(int idx) const { return mips_[idx]; }
+    // Moyennes du niveau l comme un chunk (l = 0 : chunk(idx)) ; vue vide si
+    // le niveau n'existe pas
+    ConstChunkView mipView(int idx, int level) const;
+
+    // Grille quantifiee : encode src (floats, W x H) dans le chunk idx (lignes
+    // de qStride entiers, alignees comme en float). Erreur par hauteur
+    // ~ (max-min)/131070 du chunk (demi-pas).
+    void quantizeChunk(int idx, const ConstChunkView& src);
+    bool quantized() const { return (bool)qslab_; }
+
+    // Grandes grilles : bloc en pages de 2 Mo (Linux, madvise ; ignore
+    // ailleurs), au prochain (re)dimensionnement
+    void setHugePages(bool on) { hugePages_ = on; }
+    bool hugePages() const { return hugePages_; }
+
+private:
+    struct Free { void operator()(void* p) const; };
+    std::unique_ptr<float[], Free> slab_;
+    std::unique_ptr<uint16_t[], Free> qslab_;
+    size_t qCapacity_ = 0;   // entiers alloues
+    size_t qStride_ = 0;
+    std::vector<float> qScale_, qOffset_;
+    std::vector<std::vector<ChunkMip>> mips_;
+    size_t capacity_ = 0;    // floats alloues
+    size_t count_ = 0;       // chunks
+    int W_ = 0, H_ = 0;
+    size_t stride_ = 0;
+    size_t chunkFloats_ = 0; // stride_ * H_
+    bool hugePages_ = false;
+
+    // bytes arrondi (pages de 2 Mo), mis a zero
+    static void* allocate_(size_t& bytes, bool huge);
+    // h = offset + q*scale, offset = min de v, q arrondi au plus proche
+    static void encode_(const ConstChunkView& v, uint16_t* q, size_t qStride, float& scale, float& offset);
 };
 
-} // namespace dune
\ No newline at end of file
+} // namespace dune
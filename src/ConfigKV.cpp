@@ -2,6 +2,7 @@
 #include "ConfigKV.h"
 
 #include <fstream>
+#include <iomanip>
 #include <algorithm>
 #include <cctype>
 
@@ -15,6 +16,7 @@ bool ConfigKV::save(const Params& P, const std::string& path)
     f << "# Dune Studio config\n";
     f << "version=2\n";
 
+    f << "noiseEngine=" << P.noiseEngine << "\n";
     f << "octaves=" << P.octaves << "\n";
     f << "lacunarity=" << P.lacunarity << "\n";
     f << "gain=" << P.gain << "\n";
@@ -38,6 +40,11 @@ bool ConfigKV::save(const Params& P, const std::string& path)
     f << "noiseOffsetX=" << P.noiseOffsetX << "\n";
     f << "noiseOffsetY=" << P.noiseOffsetY << "\n";
     f << "noiseZoom=" << P.noiseZoom << "\n";
+    f << "largeWorld=" << (P.largeWorld ? 1 : 0) << "\n";
+    f << std::setprecision(17);
+    f << "worldOriginX=" << P.worldOriginX << "\n";
+    f << "worldOriginY=" << P.worldOriginY << "\n";
+    f << std::setprecision(6);
 
     f << "cropLeft=" << P.cropLeft << "\n";
     f << "cropRight=" << P.cropRight << "\n";
@@ -53,6 +60,16 @@ bool ConfigKV::save(const Params& P, const std::string& path)
     f << "chunkCols=" << P.chunkCols << "\n";
     f << "chunkRows=" << P.chunkRows << "\n";
     f << "chunkGapVisual=" << P.chunkGapVisual << "\n";
+    f << "chunkStreaming=" << (P.chunkStreaming ? 1 : 0) << "\n";
+    f << std::setprecision(17);
+    f << "camWorldX=" << P.camWorldX << "\n";
+    f << "camWorldY=" << P.camWorldY << "\n";
+    f << std::setprecision(6);
+    f << "chunkCacheMB=" << P.chunkCacheMB << "\n";
+    f << "seamless=" << (P.seamless ? 1 : 0) << "\n";
+    f << "quantizedStorage=" << (P.quantizedStorage ? 1 : 0) << "\n";
+    f << "mipLevels=" << P.mipLevels << "\n";
+    f << "threadCount=" << P.threadCount << "\n";
 
     f << "filled=" << (P.filled ? 1 : 0) << "\n";
     f << "invertZ=" << (P.invertZ ? 1 : 0) << "\n";
@@ -68,6 +85,15 @@ bool ConfigKV::save(const Params& P, const std::string& path)
     f << "crestSmoothing=" << P.crestSmoothing << "\n";
     f << "crestSharpen=" << P.crestSharpen << "\n";
     f << "crestWidth=" << P.crestWidth << "\n";
+    f << "aeolianEnabled=" << (P.aeolianEnabled ? 1 : 0) << "\n";
+    f << "aeolianIterations=" << P.aeolianIterations << "\n";
+    f << "aeolianSlab=" << P.aeolianSlab << "\n";
+    f << "aeolianHop=" << P.aeolianHop << "\n";
+    f << "aeolianDepositSand=" << P.aeolianDepositSand << "\n";
+    f << "aeolianDepositBare=" << P.aeolianDepositBare << "\n";
+    f << "aeolianSandDepth=" << P.aeolianSandDepth << "\n";
+    f << "aeolianReposeDeg=" << P.aeolianReposeDeg << "\n";
+    f << "aeolianSeed=" << P.aeolianSeed << "\n";
 
     f << "crestWidth=" << P.render_intensity << "\n";
     f << "crestWidth=" << P.render_maxHeightMeters << "\n";
@@ -92,9 +118,10 @@ bool ConfigKV::load(Params& P, const std::string& path)
         std::string key = trimCopy(line.substr(0, eq));
         std::string val = trimCopy(line.substr(eq + 1));
 
-        int iv; float fv; bool bv;
+        int iv; float fv; double dv; bool bv;
 
-        if(key == "octaves" && parseIntSafe(val, iv)) P.octaves = iv;
+        if(key == "noiseEngine" && parseIntSafe(val, iv)) P.noiseEngine = iv;
+        else if(key == "octaves" && parseIntSafe(val, iv)) P.octaves = iv;
         else if(key == "lacunarity" && parseFloatSafe(val, fv)) P.lacunarity = fv;
         else if(key == "gain" && parseFloatSafe(val, fv)) P.gain = fv;
         else if(key == "freq" && parseFloatSafe(val, fv)) P.freq = fv;
@@ -117,6 +144,9 @@ bool ConfigKV::load(Params& P, const std::string& path)
         else if(key == "noiseOffsetX" && parseFloatSafe(val, fv)) P.noiseOffsetX = fv;
         else if(key == "noiseOffsetY" && parseFloatSafe(val, fv)) P.noiseOffsetY = fv;
         else if(key == "noiseZoom" && parseFloatSafe(val, fv)) P.noiseZoom = fv;
+        else if(key == "largeWorld" && parseBoolSafe(val, bv)) P.largeWorld = bv;
+        else if(key == "worldOriginX" && parseDoubleSafe(val, dv)) P.worldOriginX = dv;
+        else if(key == "worldOriginY" && parseDoubleSafe(val, dv)) P.worldOriginY = dv;
 
         else if(key == "cropLeft" && parseIntSafe(val, iv)) P.cropLeft = iv;
         else if(key == "cropRight" && parseIntSafe(val, iv)) P.cropRight = iv;
@@ -132,6 +162,14 @@ bool ConfigKV::load(Params& P, const std::string& path)
         else if(key == "chunkCols" && parseIntSafe(val, iv)) P.chunkCols = iv;
         else if(key == "chunkRows" && parseIntSafe(val, iv)) P.chunkRows = iv;
         else if(key == "chunkGapVisual" && parseFloatSafe(val, fv)) P.chunkGapVisual = fv;
+        else if(key == "chunkStreaming" && parseBoolSafe(val, bv)) P.chunkStreaming = bv;
+        else if(key == "camWorldX" && parseDoubleSafe(val, dv)) P.camWorldX = dv;
+        else if(key == "camWorldY" && parseDoubleSafe(val, dv)) P.camWorldY = dv;
+        else if(key == "chunkCacheMB" && parseIntSafe(val, iv)) P.chunkCacheMB = iv;
+        else if(key == "seamless" && parseBoolSafe(val, bv)) P.seamless = bv;
+        else if(key == "quantizedStorage" && parseBoolSafe(val, bv)) P.quantizedStorage = bv;
+        else if(key == "mipLevels" && parseIntSafe(val, iv)) P.mipLevels = iv;
+        else if(key == "threadCount" && parseIntSafe(val, iv)) P.threadCount = iv;
 
         else if(key == "filled" && parseBoolSafe(val, bv)) P.filled = bv;
         else if(key == "invertZ" && parseBoolSafe(val, bv)) P.invertZ = bv;
@@ -147,6 +185,15 @@ bool ConfigKV::load(Params& P, const std::string& path)
         else if(key == "crestSmoothing" && parseFloatSafe(val, fv)) P.crestSmoothing = fv;
         else if(key == "crestSharpen" && parseFloatSafe(val, fv)) P.crestSharpen = fv;
         else if(key == "crestWidth" && parseFloatSafe(val, fv)) P.crestWidth = fv;
+        else if(key == "aeolianEnabled" && parseBoolSafe(val, bv)) P.aeolianEnabled = bv;
+        else if(key == "aeolianIterations" && parseIntSafe(val, iv)) P.aeolianIterations = iv;
+        else if(key == "aeolianSlab" && parseFloatSafe(val, fv)) P.aeolianSlab = fv;
+        else if(key == "aeolianHop" && parseIntSafe(val, iv)) P.aeolianHop = iv;
+        else if(key == "aeolianDepositSand" && parseFloatSafe(val, fv)) P.aeolianDepositSand = fv;
+        else if(key == "aeolianDepositBare" && parseFloatSafe(val, fv)) P.aeolianDepositBare = fv;
+        else if(key == "aeolianSandDepth" && parseFloatSafe(val, fv)) P.aeolianSandDepth = fv;
+        else if(key == "aeolianReposeDeg" && parseFloatSafe(val, fv)) P.aeolianReposeDeg = fv;
+        else if(key == "aeolianSeed" && parseIntSafe(val, iv)) P.aeolianSeed = iv;
 
         else if(key == "render_intensity" && parseFloatSafe(val, fv)) P.render_intensity = fv;
         else if(key == "render_maxHeightMeters" && parseFloatSafe(val, fv)) P.render_maxHeightMeters = fv;
@@ -187,6 +234,17 @@ bool ConfigKV::parseFloatSafe(const std::string& s, float& out)
     }catch(...){ return false; }
 }
 
+bool ConfigKV::parseDoubleSafe(const std::string& s, double& out)
+{
+    try{
+        std::string t = trimCopy(s);
+        size_t pos=0;
+        double v=std::stod(t,&pos);
+        if(pos!=t.size()) return false;
+        out=v; return true;
+    }catch(...){ return false; }
+}
+
 bool ConfigKV::parseBoolSafe(const std::string& s, bool& out)
 {
     std::string v = trimCopy(s);
@@ -16,6 +16,7 @@ private:
     static std::string trimCopy(const std::string& s);
     static bool parseIntSafe(const std::string& s, int& out);
     static bool parseFloatSafe(const std::string& s, float& out);
+    static bool parseDoubleSafe(const std::string& s, double& out);
     static bool parseBoolSafe(const std::string& s, bool& out);
 };
 
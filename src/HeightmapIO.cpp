@@ -7,6 +7,8 @@
 #include <chrono>
 #include <ctime>
 #include <cstdio>
+#include <cstdint>
+#include <cstring>
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
@@ -65,7 +67,7 @@ namespace dune
         float *outMin, float *outMax,
         int *outAtlasW, int *outAtlasH)
     {
-        if (grid.cols <= 0 || grid.rows <= 0 || grid.heights.empty())
+        if (grid.empty() || grid.chunkW() != W || grid.chunkH() != H)
         {
             outRGBA.clear();
             if (outAtlasW)
@@ -75,13 +77,31 @@ namespace dune
             return;
         }
 
+        // Min/max : niveau le plus grossier de la pyramide s'il existe
         float mn = 1e30f, mx = -1e30f;
-        for (const auto &chunk : grid.heights)
+        std::vector<float> tmp((size_t)W);
+        for (int i = 0; i < grid.cols * grid.rows; ++i)
         {
-            for (float v : chunk)
+            const std::vector<ChunkMip> &mips = grid.mips(i);
+            if (!mips.empty())
             {
-                mn = std::min(mn, v);
-                mx = std::max(mx, v);
+                const ChunkMip &top = mips.back();
+                for (size_t k = 0; k < top.mn.size(); ++k)
+                {
+                    mn = std::min(mn, top.mn[k]);
+                    mx = std::max(mx, top.mx[k]);
+                }
+                continue;
+            }
+            const ConstChunkView chunk = grid.chunk(i);
+            for (int y = 0; y < H; ++y)
+            {
+                const float *row = chunk.row(y, tmp.data());
+                for (int x = 0; x < W; ++x)
+                {
+                    mn = std::min(mn, row[x]);
+                    mx = std::max(mx, row[x]);
+                }
             }
         }
         if (outMin)
@@ -113,7 +133,7 @@ namespace dune
         {
             for (int c = 0; c < grid.cols; ++c)
             {
-                const auto &chunk = grid.heights[ChunkGrid::index(c, r, grid.cols)];
+                const ConstChunkView chunk = grid.chunk(ChunkGrid::index(c, r, grid.cols));
                 int ox = c * (W + gapPx);
                 int oy = r * (H + gapPx);
 
@@ -121,7 +141,7 @@ namespace dune
                 {
                     for (int x = 0; x < W; ++x)
                     {
-                        float v = chunk[y * W + x];
+                        float v = chunk.at(x, y);
                         float t = (v - mn) / denom;
                         t = std::clamp(t, 0.0f, 1.0f);
                         unsigned char g = (unsigned char)std::lround(t * 255.0f);
@@ -136,28 +156,6 @@ namespace dune
         }
     }
 
-    void HeightmapIO::ensureOrUpdateTextureRGBA8(GLuint &tex, int W, int H, const unsigned char *dataRGBA)
-    {
-        if (tex == 0)
-        {
-            glGenTextures(1, &tex);
-            glBindTexture(GL_TEXTURE_2D, tex);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, W, H, 0, GL_RGBA, GL_UNSIGNED_BYTE, dataRGBA);
-            glBindTexture(GL_TEXTURE_2D, 0);
-            return;
-        }
-
-        glBindTexture(GL_TEXTURE_2D, tex);
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, W, H, 0, GL_RGBA, GL_UNSIGNED_BYTE, dataRGBA);
-        glBindTexture(GL_TEXTURE_2D, 0);
-    }
-
     std::string HeightmapIO::makeTimestampedFilename(const char *prefix, const char *ext)
     {
         using namespace std::chrono;
@@ -178,17 +176,36 @@ namespace dune
         return std::string(buf);
     }
 
+    // Min/max d'un chunk (lignes de la vue)
+    static void viewMinMax(const ConstChunkView &h, float &mn, float &mx)
+    {
+        mn = 1e30f;
+        mx = -1e30f;
+        std::vector<float> tmp((size_t)h.W);
+        for (int y = 0; y < h.H; ++y)
+        {
+            const float *row = h.row(y, tmp.data());
+            for (int x = 0; x < h.W; ++x)
+            {
+                mn = std::min(mn, row[x]);
+                mx = std::max(mx, row[x]);
+            }
+        }
+    }
+
     bool HeightmapIO::exportPGM(const std::vector<float> &heights, int W, int H, const std::string &filename)
     {
-        if ((int)heights.size() != W * H)
+        return exportPGM(viewOf(heights, W, H), filename);
+    }
+
+    bool HeightmapIO::exportPGM(const ConstChunkView &heights, const std::string &filename)
+    {
+        if (heights.empty())
             return false;
+        const int W = heights.W, H = heights.H;
 
-        float mn = 1e30f, mx = -1e30f;
-        for (float v : heights)
-        {
-            mn = std::min(mn, v);
-            mx = std::max(mx, v);
-        }
+        float mn, mx;
+        viewMinMax(heights, mn, mx);
         float denom = (mx - mn);
         if (denom < 1e-9f)
             denom = 1.0f;
@@ -204,7 +221,7 @@ namespace dune
         {
             for (int x = 0; x < W; ++x)
             {
-                float v = heights[y * W + x];
+                float v = heights.at(x, y);
                 float t = (v - mn) / denom;
                 t = std::clamp(t, 0.0f, 1.0f);
                 line[(size_t)x] = (unsigned char)std::lround(t * 255.0f);
@@ -222,54 +239,130 @@ namespace dune
                                   const float maxHeightMeters,
                                   const float unrealHalfRange)
     {
-        if (heights.empty() || width <= 0 || height <= 0)
-            return false;
-        if ((int)heights.size() != width * height)
+        return exportRAW16(viewOf(heights, width, height), filename, intensity, maxHeightMeters, unrealHalfRange);
+    }
+
+    bool HeightmapIO::exportRAW16(const ConstChunkView &heights,
+                                  const std::string &filename,
+                                  const float intensity,
+                                  const float maxHeightMeters,
+                                  const float unrealHalfRange)
+    {
+        if (heights.empty())
             return false;
 
         std::ofstream file(filename, std::ios::binary);
         if (!file.is_open())
             return false;
 
-        for (int i = 0; i < width * height; ++i)
+        std::vector<float> tmp((size_t)heights.W);
+        for (int y = 0; y < heights.H; ++y)
         {
-            float hMeters = heights[i];
+            const float *row = heights.row(y, tmp.data());
+            for (int x = 0; x < heights.W; ++x)
+            {
+                float hMeters = row[x];
 
-            // 1) Réduction d'intensité à l'export
-            hMeters *= intensity;
+                // 1) Réduction d'intensité à l'export
+                hMeters *= intensity;
 
-            // 2) Clamp (évite overflow)
-            hMeters = std::clamp(hMeters, -maxHeightMeters, maxHeightMeters);
+                // 2) Clamp (évite overflow)
+                hMeters = std::clamp(hMeters, -maxHeightMeters, maxHeightMeters);
 
-            // 3) Map vers [-unrealHalfRange .. +unrealHalfRange]
-            float landscapeValue = (hMeters / maxHeightMeters) * unrealHalfRange;
+                // 3) Map vers [-unrealHalfRange .. +unrealHalfRange]
+                float landscapeValue = (hMeters / maxHeightMeters) * unrealHalfRange;
 
-            // 4) Map vers [0..1]
-            float normalized = (landscapeValue + unrealHalfRange) / (2.0f * unrealHalfRange);
-            normalized = std::clamp(normalized, 0.0f, 1.0f);
+                // 4) Map vers [0..1]
+                float normalized = (landscapeValue + unrealHalfRange) / (2.0f * unrealHalfRange);
+                normalized = std::clamp(normalized, 0.0f, 1.0f);
 
-            // 5) Quantification U16
-            uint16_t value = (uint16_t)std::lround(normalized * 65535.0f);
+                // 5) Quantification U16
+                uint16_t value = (uint16_t)std::lround(normalized * 65535.0f);
 
-            // 6) Écriture little-endian
-            file.put((char)(value & 0xFF));
-            file.put((char)((value >> 8) & 0xFF));
+                // 6) Écriture little-endian
+                file.put((char)(value & 0xFF));
+                file.put((char)((value >> 8) & 0xFF));
+            }
         }
 
         return true;
     }
 
-    bool HeightmapIO::exportPNG(const std::vector<float> &heights, int W, int H, const std::string &filename)
+    bool HeightmapIO::exportRAW32F(const std::vector<float> &heights, int W, int H, const std::string &filename)
     {
-        if ((int)heights.size() != W * H)
+        return exportRAW32F(viewOf(heights, W, H), filename);
+    }
+
+    bool HeightmapIO::exportRAW32F(const ConstChunkView &heights, const std::string &filename)
+    {
+        if (heights.empty())
             return false;
+        const int W = heights.W, H = heights.H;
 
-        float mn = 1e30f, mx = -1e30f;
-        for (float v : heights)
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        std::vector<unsigned char> line((size_t)W * 4);
+        for (int y = 0; y < H; ++y)
         {
-            mn = std::min(mn, v);
-            mx = std::max(mx, v);
+            for (int x = 0; x < W; ++x)
+            {
+                const float v = heights.at(x, y);
+                uint32_t bits;
+                std::memcpy(&bits, &v, 4);
+                unsigned char *b = &line[(size_t)x * 4];
+                b[0] = (unsigned char)(bits & 0xFF);
+                b[1] = (unsigned char)((bits >> 8) & 0xFF);
+                b[2] = (unsigned char)((bits >> 16) & 0xFF);
+                b[3] = (unsigned char)((bits >> 24) & 0xFF);
+            }
+            file.write((const char *)line.data(), (std::streamsize)line.size());
+        }
+        return (bool)file;
+    }
+
+    bool HeightmapIO::importRAW32F(std::vector<float> &heights, int W, int H, const std::string &filename)
+    {
+        if (W <= 0 || H <= 0)
+            return false;
+
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            return false;
+        if ((size_t)file.tellg() != (size_t)W * (size_t)H * 4)
+            return false;
+        file.seekg(0);
+
+        heights.resize((size_t)W * (size_t)H);
+        std::vector<unsigned char> line((size_t)W * 4);
+        for (int y = 0; y < H; ++y)
+        {
+            if (!file.read((char *)line.data(), (std::streamsize)line.size()))
+                return false;
+            for (int x = 0; x < W; ++x)
+            {
+                const unsigned char *b = &line[(size_t)x * 4];
+                uint32_t bits = (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+                std::memcpy(&heights[(size_t)y * W + x], &bits, 4);
+            }
         }
+        return true;
+    }
+
+    bool HeightmapIO::exportPNG(const std::vector<float> &heights, int W, int H, const std::string &filename)
+    {
+        return exportPNG(viewOf(heights, W, H), filename);
+    }
+
+    bool HeightmapIO::exportPNG(const ConstChunkView &heights, const std::string &filename)
+    {
+        if (heights.empty())
+            return false;
+        const int W = heights.W, H = heights.H;
+
+        float mn, mx;
+        viewMinMax(heights, mn, mx);
         float denom = (mx - mn);
         if (denom < 1e-9f)
             denom = 1.0f;
@@ -279,7 +372,7 @@ namespace dune
         {
             for (int x = 0; x < W; ++x)
             {
-                float v = heights[y * W + x];
+                float v = heights.at(x, y);
                 float t = (v - mn) / denom;
                 t = std::clamp(t, 0.0f, 1.0f);
                 pixels[(size_t)y * W + (size_t)x] = (unsigned char)std::lround(t * 255.0f);
@@ -294,7 +387,7 @@ namespace dune
         const std::string &basePrefix,
         std::string &outMessage)
     {
-        if (grid.heights.empty())
+        if (grid.empty() || grid.chunkW() != W || grid.chunkH() != H)
         {
             outMessage = "Aucun chunk a exporter";
             return false;
@@ -308,9 +401,9 @@ namespace dune
         {
             for (int c = 0; c < grid.cols; ++c)
             {
-                const auto &h = grid.heights[ChunkGrid::index(c, r, grid.cols)];
+                const ConstChunkView h = grid.chunk(ChunkGrid::index(c, r, grid.cols));
                 std::string filename = basePrefix + "_r" + std::to_string(r) + "_c" + std::to_string(c) + ".png";
-                if (exportPNG(h, W, H, filename))
+                if (exportPNG(h, filename))
                     okCount++;
                 else
                     allOk = false;
@@ -321,6 +414,38 @@ namespace dune
         return allOk;
     }
 
+    bool HeightmapIO::exportAllChunksPGM(
+        const ChunkGrid &grid, int W, int H,
+        const std::string &basePrefix,
+        std::string &outMessage)
+    {
+        if (grid.empty() || grid.chunkW() != W || grid.chunkH() != H)
+        {
+            outMessage = "Aucun chunk a exporter";
+            return false;
+        }
+
+        bool allOk = true;
+        int okCount = 0;
+        int total = grid.cols * grid.rows;
+
+        for (int r = 0; r < grid.rows; ++r)
+        {
+            for (int c = 0; c < grid.cols; ++c)
+            {
+                const ConstChunkView h = grid.chunk(ChunkGrid::index(c, r, grid.cols));
+                std::string filename = basePrefix + "_r" + std::to_string(r) + "_c" + std::to_string(c) + ".pgm";
+                if (exportPGM(h, filename))
+                    okCount++;
+                else
+                    allOk = false;
+            }
+        }
+
+        outMessage = "Export PGM chunks: " + std::to_string(okCount) + "/" + std::to_string(total);
+        return allOk;
+    }
+
     bool HeightmapIO::exportAllChunksRAW16(
         const ChunkGrid &grid, int W, int H,
         const std::string &basePrefix,
@@ -329,7 +454,7 @@ namespace dune
         const float maxHeightMeters,
         const float unrealHalfRange)
     {
-        if (grid.heights.empty())
+        if (grid.empty() || grid.chunkW() != W || grid.chunkH() != H)
         {
             outMessage = "Aucun chunk a exporter";
             return false;
@@ -343,10 +468,10 @@ namespace dune
         {
             for (int c = 0; c < grid.cols; ++c)
             {
-                const auto &h = grid.heights[ChunkGrid::index(c, r, grid.cols)];
+                const ConstChunkView h = grid.chunk(ChunkGrid::index(c, r, grid.cols));
                 std::string filename = basePrefix + "_r" + std::to_string(r) + "_c" + std::to_string(c) + ".r16";
 
-                if (exportRAW16(h, W, H, filename, intensity, maxHeightMeters, unrealHalfRange))
+                if (exportRAW16(h, filename, intensity, maxHeightMeters, unrealHalfRange))
                     okCount++;
                 else
                     allOk = false;
@@ -3,7 +3,6 @@
 
 #include <string>
 #include <vector>
-#include "GLCompat.h"
 
 #include "ChunkGrid.h"
 
@@ -25,20 +24,33 @@ namespace dune
             float *outMin = nullptr, float *outMax = nullptr,
             int *outAtlasW = nullptr, int *outAtlasH = nullptr);
 
-        static void ensureOrUpdateTextureRGBA8(GLuint &tex, int W, int H, const unsigned char *dataRGBA);
-
         static std::string makeTimestampedFilename(const char *prefix, const char *ext);
 
+        // Buffers denses W*H, ou vues sur un chunk (ChunkGrid::chunk)
         static bool exportRAW16(const std::vector<float> &heights, int W, int H, const std::string &filename, 
                                 const float intensity = 0.03f, const float maxHeightMeters = 30.0f, const float unrealHalfRange = 1.0f);
+        static bool exportRAW16(const ConstChunkView &heights, const std::string &filename,
+                                const float intensity = 0.03f, const float maxHeightMeters = 30.0f, const float unrealHalfRange = 1.0f);
+        // Hauteurs brutes en float32 little-endian (.r32), sans mise a l'echelle
+        static bool exportRAW32F(const std::vector<float> &heights, int W, int H, const std::string &filename);
+        static bool exportRAW32F(const ConstChunkView &heights, const std::string &filename);
+        // Relit un .r32 de W*H floats ; false si la taille du fichier differe
+        static bool importRAW32F(std::vector<float> &heights, int W, int H, const std::string &filename);
         static bool exportPGM(const std::vector<float> &heights, int W, int H, const std::string &filename);
+        static bool exportPGM(const ConstChunkView &heights, const std::string &filename);
         static bool exportPNG(const std::vector<float> &heights, int W, int H, const std::string &filename);
+        static bool exportPNG(const ConstChunkView &heights, const std::string &filename);
 
         static bool exportAllChunksPNG(
             const ChunkGrid &grid, int W, int H,
             const std::string &basePrefix,
             std::string &outMessage);
 
+        static bool exportAllChunksPGM(
+            const ChunkGrid &grid, int W, int H,
+            const std::string &basePrefix,
+            std::string &outMessage);
+
         static bool exportAllChunksRAW16(
             const ChunkGrid &grid, int W, int H,
             const std::string &basePrefix,
@@ -0,0 +1,29 @@
+// src/HeightmapTexture.cpp
+#include "HeightmapTexture.h"
+
+namespace dune
+{
+
+    void HeightmapTexture::ensureOrUpdateRGBA8(GLuint &tex, int W, int H, const unsigned char *dataRGBA)
+    {
+        if (tex == 0)
+        {
+            glGenTextures(1, &tex);
+            glBindTexture(GL_TEXTURE_2D, tex);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, W, H, 0, GL_RGBA, GL_UNSIGNED_BYTE, dataRGBA);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            return;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, W, H, 0, GL_RGBA, GL_UNSIGNED_BYTE, dataRGBA);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+} // namespace dune
@@ -0,0 +1,17 @@
+// src/HeightmapTexture.h
+#pragma once
+
+#include "GLCompat.h"
+
+namespace dune
+{
+
+    // Upload GL de l'atlas RGBA8 (viewer seulement, hors de dune_core)
+    class HeightmapTexture
+    {
+
+    public:
+        static void ensureOrUpdateRGBA8(GLuint &tex, int W, int H, const unsigned char *dataRGBA);
+    };
+
+} // namespace dune
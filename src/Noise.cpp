@@ -1,23 +1,32 @@
 // src/Noise.cpp
 #include "Noise.h"
+#include "NoiseSimd.h"
 
-#include <vector>
+#include <atomic>
 #include <random>
+#include <vector>
 #include <algorithm>
 #include <cmath>
 
 namespace dune {
 
+static std::atomic<int> g_maxSimd{ (int)SimdLevel::AVX512 };
+
 void Noise::init(uint32_t seed)
 {
+    seed_ = seed;
     std::vector<int> perm(256);
     std::mt19937 rng(seed);
     for(int i=0;i<256;i++) perm[i]=i;
     std::shuffle(perm.begin(),perm.end(),rng);
     for(int i=0;i<512;i++) p_[i]=perm[i&255];
+
+    cells_.resize(simd::kPreviewCells + 1);
+    simd::fillPreviewCells(p_, cells_.data());
 }
 
 float Noise::fade(float t){ return t*t*t*(t*(t*6-15)+10); }
+float Noise::dfade(float t){ float tm=t-1; return 30.f*(t*t)*(tm*tm); }
 float Noise::lerp(float a,float b,float t){ return a + t*(b-a); }
 
 float Noise::grad(int hash,float x,float y){
@@ -28,40 +37,247 @@ float Noise::grad(int hash,float x,float y){
 }
 
 float Noise::perlin(float x, float y) const
+{
+    return perlinP_(p_, x, y);
+}
+
+float Noise::perlinP_(const int* p, float x, float y)
 {
     int X=(int)floor(x)&255;
     int Y=(int)floor(y)&255;
     x-=floor(x); y-=floor(y);
     float u=fade(x), v=fade(y);
-    int A=p_[X]+Y, B=p_[X+1]+Y;
+    int A=p[X]+Y, B=p[X+1]+Y;
 
     return lerp(
-        lerp(grad(p_[A],x,y),     grad(p_[B],x-1,y), u),
-        lerp(grad(p_[A+1],x,y-1), grad(p_[B+1],x-1,y-1), u),
+        lerp(grad(p[A],x,y),     grad(p[B],x-1,y), u),
+        lerp(grad(p[A+1],x,y-1), grad(p[B+1],x-1,y-1), u),
         v
     );
 }
 
-float Noise::fbm(float x,float y,int oct,float lac,float gain) const
+float Noise::perlinD(float x, float y, float& dx, float& dy) const
+{
+    return perlinDP_(p_, x, y, dx, dy);
+}
+
+static inline float lerpCell(float a,float b,float t){ return a + t*(b-a); }
+
+// perlin + gradient a partir des gradients de coin de la cellule
+static inline float perlinDCell(const simd::CellCache& c, float x, float y, float u, float v,
+                                float dfx, float dfy, float& dx, float& dy)
+{
+    // memes termes que perlinP_ (grad == gx*x + gy*y)
+    float g00 = x*c.gx[0] + y*c.gy[0];
+    float g10 = (x-1)*c.gx[1] + y*c.gy[1];
+    float g01 = x*c.gx[2] + (y-1)*c.gy[2];
+    float g11 = (x-1)*c.gx[3] + (y-1)*c.gy[3];
+
+    // n = g00 + u k1 + v k2 + uv k3
+    float k1 = g10-g00, k2 = g01-g00, k3 = g00-g10-g01+g11;
+    float uv = u*v;
+    dx = c.gx[0] + u*(c.gx[1]-c.gx[0]) + v*(c.gx[2]-c.gx[0]) + uv*(c.gx[0]-c.gx[1]-c.gx[2]+c.gx[3])
+       + dfx*(k1 + v*k3);
+    dy = c.gy[0] + u*(c.gy[1]-c.gy[0]) + v*(c.gy[2]-c.gy[0]) + uv*(c.gy[0]-c.gy[1]-c.gy[2]+c.gy[3])
+       + dfy*(k2 + u*k3);
+
+    return lerpCell(lerpCell(g00, g10, u), lerpCell(g01, g11, u), v);
+}
+
+float Noise::perlinDP_(const void* ctx, float x, float y, float& dx, float& dy)
+{
+    const int* p = (const int*)ctx;
+    int X=(int)floor(x)&255;
+    int Y=(int)floor(y)&255;
+    x-=floor(x); y-=floor(y);
+    float u=fade(x), v=fade(y);
+    simd::CellCache c;
+    simd::fillCell(p, X, Y, c);
+    return perlinDCell(c, x, y, u, v, dfade(x), dfade(y), dx, dy);
+}
+
+float Noise::perlinDW_(const void* ctx, int32_t cx, int32_t cy, float x, float y, float& dx, float& dy)
+{
+    const float fx = std::floor(x), fy = std::floor(y);
+    x-=fx; y-=fy;
+    float u=fade(x), v=fade(y);
+    simd::CellCache c;
+    simd::fillCellHashed(*(const uint32_t*)ctx, cellAdd(cx, (int32_t)fx), cellAdd(cy, (int32_t)fy), c);
+    return perlinDCell(c, x, y, u, v, dfade(x), dfade(y), dx, dy);
+}
+
+SimdLevel Noise::simdLevel()
+{
+    static const SimdLevel detected = simd::detectLevel();
+    return (SimdLevel)std::min((int)detected, g_maxSimd.load(std::memory_order_relaxed));
+}
+
+void Noise::setMaxSimdLevel(SimdLevel lvl)
+{
+    g_maxSimd.store((int)lvl, std::memory_order_relaxed);
+}
+
+const char* Noise::simdLevelName(SimdLevel lvl)
+{
+    switch(lvl){
+        case SimdLevel::AVX512: return "AVX-512";
+        case SimdLevel::AVX2:   return "AVX2";
+        case SimdLevel::SSE41:  return "SSE4.1";
+        default: return "scalaire";
+    }
+}
+
+template<int Oct, bool Ridged>
+void Noise::rowScalar_(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                       int oct, float lac, float gain)
+{
+    const int* perm = (const int*)ctx;
+    const int nOct = Oct ? Oct : oct;
+    simd::CellCache cache[simd::kCellCaches];
+    for(int i=0;i<n;i++){
+        float amp=0.5f,freq=1.f,sum=0;
+        for(int o=0;o<nOct;o++){
+            // perlinP_ avec les coins de cellule mis en cache (cf. CellCache)
+            float x = xs[i]*freq, y = ys[i]*freq;
+            float fx = std::floor(x), fy = std::floor(y);
+            int X=(int)fx&255, Y=(int)fy&255;
+            x-=fx; y-=fy;
+            simd::CellCache& c = cache[o & (simd::kCellCaches-1)];
+            if(X != c.X || Y != c.Y) simd::fillCell(perm, X, Y, c);
+            float u=fade(x), v=fade(y);
+            float p = lerp(
+                lerp(x*c.gx[0] + y*c.gy[0],     (x-1)*c.gx[1] + y*c.gy[1], u),
+                lerp(x*c.gx[2] + (y-1)*c.gy[2], (x-1)*c.gx[3] + (y-1)*c.gy[3], u),
+                v
+            );
+            if(Ridged){
+                float r = 1.f - fabsf(p);
+                r*=r;
+                sum += r*amp;
+            }else{
+                sum += amp*p;
+            }
+            freq*=lac; amp*=gain;
+        }
+        out[i] = Ridged ? std::clamp(sum,0.f,1.f) : sum;
+    }
+}
+
+Noise::RowKernel Noise::rowKernel(bool ridged, int oct, float lac, float gain) const
 {
-    float amp=0.5f,freq=1.f,sum=0;
-    for(int i=0;i<oct;i++){
-        sum+=amp*perlin(x*freq,y*freq);
-        freq*=lac; amp*=gain;
+    static const RowKernel::Fn scalar[2][kMaxSpecializedOctaves+1] = {
+        { rowScalar_<0,false>, rowScalar_<1,false>, rowScalar_<2,false>, rowScalar_<3,false>,
+          rowScalar_<4,false>, rowScalar_<5,false>, rowScalar_<6,false>, rowScalar_<7,false>,
+          rowScalar_<8,false>, rowScalar_<9,false>, rowScalar_<10,false> },
+        { rowScalar_<0,true>,  rowScalar_<1,true>,  rowScalar_<2,true>,  rowScalar_<3,true>,
+          rowScalar_<4,true>,  rowScalar_<5,true>,  rowScalar_<6,true>,  rowScalar_<7,true>,
+          rowScalar_<8,true>,  rowScalar_<9,true>,  rowScalar_<10,true> }
+    };
+
+    RowKernel k;
+    k.fn = simd::fbmRowKernel(simdLevel(), ridged, oct);
+    if(!k.fn){
+        const int o = (oct >= 1 && oct <= kMaxSpecializedOctaves) ? oct : 0;
+        k.fn = scalar[ridged][o];
     }
-    return sum;
+    k.fnD = simd::fbmRowDKernel(simdLevel(), ridged);
+    if(!k.fnD) k.fnD = genericRowKernelD<&Noise::perlinDP_>(ridged);
+    k.ctx = p_;
+    k.oct = oct; k.lac = lac; k.gain = gain;
+    return k;
 }
 
-float Noise::ridgedFBM(float x,float y,int oct,float lac,float gain) const
+template<bool Ridged>
+void Noise::rowWorld_(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                      int oct, float lac, float gain)
 {
-    float amp=0.5f,freq=1.f,sum=0;
-    for(int i=0;i<oct;i++){
-        float r = 1.f - fabsf(perlin(x*freq,y*freq));
-        r*=r;
-        sum += r*amp;
-        freq*=lac; amp*=gain;
+    // rowScalar_ avec cellule d'origine par octave et gradients hashes
+    const WorldOrigin& w = *(const WorldOrigin*)ctx;
+    const uint32_t seed = *(const uint32_t*)w.base;
+    simd::CellCache cache[kMaxOctaves];
+    for(int o=0;o<oct;o++) simd::fillCellHashed(seed, w.o[o].cx, w.o[o].cy, cache[o]);
+    for(int i=0;i<n;i++){
+        float amp=0.5f,freq=1.f,sum=0;
+        for(int o=0;o<oct;o++){
+            const LatticeOrigin& g = w.o[o];
+            float x = g.fx + xs[i]*freq, y = g.fy + ys[i]*freq;
+            float fx = std::floor(x), fy = std::floor(y);
+            int32_t X = cellAdd(g.cx, (int32_t)fx), Y = cellAdd(g.cy, (int32_t)fy);
+            x-=fx; y-=fy;
+            simd::CellCache& c = cache[o];
+            if(X != c.X || Y != c.Y) simd::fillCellHashed(seed, X, Y, c);
+            float u=fade(x), v=fade(y);
+            float p = lerp(
+                lerp(x*c.gx[0] + y*c.gy[0],     (x-1)*c.gx[1] + y*c.gy[1], u),
+                lerp(x*c.gx[2] + (y-1)*c.gy[2], (x-1)*c.gx[3] + (y-1)*c.gy[3], u),
+                v
+            );
+            if(Ridged){
+                float r = 1.f - fabsf(p);
+                r*=r;
+                sum += r*amp;
+            }else{
+                sum += amp*p;
+            }
+            freq*=lac; amp*=gain;
+        }
+        out[i] = Ridged ? std::clamp(sum,0.f,1.f) : sum;
     }
-    return std::clamp(sum,0.f,1.f);
 }
 
-} // namespace dune
\ No newline at end of file
+Noise::RowKernel Noise::worldRowKernel(bool ridged, int oct, float lac, float gain,
+                                       double originX, double originY, WorldOrigin& w) const
+{
+    w.base = &seed_;
+    fillWorldOrigin(originX, originY, oct, lac, w);
+    RowKernel k;
+    k.fn = simd::worldRowKernel(simdLevel(), ridged);
+    if(!k.fn) k.fn = ridged ? &rowWorld_<true> : &rowWorld_<false>;
+    k.fnD = ridged ? &genericRowDW<&Noise::perlinDW_,true> : &genericRowDW<&Noise::perlinDW_,false>;
+    k.ctx = &w;
+    k.oct = std::min(oct, kMaxOctaves); k.lac = lac; k.gain = gain;
+    return k;
+}
+
+template<bool Ridged>
+void Noise::rowPreview_(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                        int oct, float lac, float gain)
+{
+    // reference scalaire des noyaux simd::previewRow* (memes arrondis)
+    const uint16_t* cells = (const uint16_t*)ctx;
+    for(int i=0;i<n;i++){
+        float amp=0.5f,freq=1.f;
+        int sum=0;
+        for(int o=0;o<oct;o++){
+            float x = xs[i]*freq, y = ys[i]*freq;
+            float fx = std::floor(x), fy = std::floor(y);
+            int X=(int)fx&255, Y=(int)fy&255;
+            int qx = std::min((int)((x-fx)*32768.f), 32767);
+            int qy = std::min((int)((y-fy)*32768.f), 32767);
+            int p = simd::perlinQ12(cells[X | (Y<<8)], qx, qy);
+            int a = std::min(32767, (int)(amp*32768.f));
+            if(Ridged){
+                int r = 4096 - std::abs(p);
+                int r2 = 2*simd::mulhrsQ(r, 4*r);
+                sum = simd::satQ(sum + simd::mulhrsQ(r2, a));
+            }else{
+                sum = simd::satQ(sum + simd::mulhrsQ(p, a));
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged) sum = std::clamp(sum, 0, 4096);
+        out[i] = (float)sum * (1.f/4096.f);
+    }
+}
+
+Noise::RowKernel Noise::previewRowKernel(bool ridged, int oct, float lac, float gain) const
+{
+    RowKernel k;
+    k.fn = simd::previewRowKernel(simdLevel(), ridged);
+    if(!k.fn) k.fn = ridged ? &rowPreview_<true> : &rowPreview_<false>;
+    k.ctx = cells_.data();
+    k.oct = oct; k.lac = lac; k.gain = gain;
+    return k;
+}
+
+} // namespace dune
@@ -2,23 +2,68 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
+
+#include "NoiseBackend.h"
 
 namespace dune {
 
-class Noise {
+// Jeu d'instructions utilise par les noyaux "row" (detecte au runtime).
+enum class SimdLevel { Scalar = 0, SSE41, AVX2, AVX512 };
+
+// Moteur Perlin classique (table de permutation 512), avec noyaux SIMD.
+class Noise : public NoiseBackend {
 public:
-    void init(uint32_t seed = 1337);
+    NoiseEngine engine() const override { return NoiseEngine::Perlin; }
+    void init(uint32_t seed = 1337) override;
+    uint32_t seed() const override { return seed_; }
 
+    float sample(float x, float y) const override { return perlin(x, y); }
+    float sampleD(float x, float y, float& dx, float& dy) const override { return perlinD(x, y, dx, dy); }
     float perlin(float x, float y) const;
-    float fbm(float x,float y,int oct,float lac,float gain) const;
-    float ridgedFBM(float x,float y,int oct,float lac,float gain) const;
+    // Valeur identique a perlin() + gradient analytique
+    float perlinD(float x, float y, float& dx, float& dy) const;
+
+    // Les noyaux SIMD suivent exactement l'ordre des operations du chemin
+    // scalaire (pas de FMA) : l'ecart attendu est nul, la tolerance
+    // documentee est 1e-6 en absolu.
+    RowKernel rowKernel(bool ridged, int oct, float lac, float gain) const override;
+
+    // Apercu int16 virgule fixe (fade cubique, une lecture de table par
+    // cellule) : ecart typique ~1e-2 par rapport a rowKernel.
+    RowKernel previewRowKernel(bool ridged, int oct, float lac, float gain) const override;
+
+    // Monde etendu : gradients de coin par hash 32 bits (periode 2^32 cellules
+    // au lieu de 256). Noyaux AVX2 / AVX-512 (hash vectoriel), scalaire sinon.
+    RowKernel worldRowKernel(bool ridged, int oct, float lac, float gain,
+                             double originX, double originY, WorldOrigin& w) const override;
+
+    static SimdLevel simdLevel();
+    static void setMaxSimdLevel(SimdLevel lvl); // debug / bench : force un niveau plus bas
+    static const char* simdLevelName(SimdLevel lvl);
 
 private:
     int p_[512]{};
+    uint32_t seed_ = 1337;
+    std::vector<uint16_t> cells_; // codes de gradient par cellule (apercu)
 
     static float fade(float t);
     static float lerp(float a,float b,float t);
     static float grad(int hash,float x,float y);
+    static float dfade(float t);
+    static float perlinP_(const int* p, float x, float y);
+    static float perlinDP_(const void* ctx, float x, float y, float& dx, float& dy);
+    static float perlinDW_(const void* ctx, int32_t cx, int32_t cy, float x, float y, float& dx, float& dy);
+
+    template<int Oct, bool Ridged>
+    static void rowScalar_(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                           int oct, float lac, float gain);
+    template<bool Ridged>
+    static void rowWorld_(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                          int oct, float lac, float gain);
+    template<bool Ridged>
+    static void rowPreview_(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                            int oct, float lac, float gain);
 };
 
-} // namespace dune
\ No newline at end of file
+} // namespace dune
@@ -0,0 +1,146 @@
+// src/NoiseBackend.cpp
+#include "NoiseBackend.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "Noise.h"
+#include "OpenSimplex2Noise.h"
+#include "ValueNoise.h"
+
+namespace dune {
+
+float NoiseBackend::fbm(float x,float y,int oct,float lac,float gain) const
+{
+    float amp=0.5f,freq=1.f,sum=0;
+    for(int i=0;i<oct;i++){
+        sum+=amp*sample(x*freq,y*freq);
+        freq*=lac; amp*=gain;
+    }
+    return sum;
+}
+
+float NoiseBackend::ridgedFBM(float x,float y,int oct,float lac,float gain) const
+{
+    float amp=0.5f,freq=1.f,sum=0;
+    for(int i=0;i<oct;i++){
+        float r = 1.f - fabsf(sample(x*freq,y*freq));
+        r*=r;
+        sum += r*amp;
+        freq*=lac; amp*=gain;
+    }
+    return std::clamp(sum,0.f,1.f);
+}
+
+float NoiseBackend::fbmD(float x,float y,int oct,float lac,float gain, float& dx, float& dy) const
+{
+    float amp=0.5f,freq=1.f,sum=0;
+    dx = dy = 0.f;
+    for(int i=0;i<oct;i++){
+        float px,py;
+        sum+=amp*sampleD(x*freq,y*freq,px,py);
+        dx+=amp*freq*px; dy+=amp*freq*py;
+        freq*=lac; amp*=gain;
+    }
+    return sum;
+}
+
+float NoiseBackend::ridgedFBMD(float x,float y,int oct,float lac,float gain, float& dx, float& dy) const
+{
+    float amp=0.5f,freq=1.f,sum=0;
+    dx = dy = 0.f;
+    for(int i=0;i<oct;i++){
+        float px,py;
+        float p = sampleD(x*freq,y*freq,px,py);
+        float r = 1.f - fabsf(p);
+        float k = -2.f*r*amp*freq;
+        if(p < 0.f) k = -k;
+        r*=r;
+        sum += r*amp;
+        dx += k*px; dy += k*py;
+        freq*=lac; amp*=gain;
+    }
+    if(sum < 0.f || sum > 1.f){ dx = 0.f; dy = 0.f; }
+    return std::clamp(sum,0.f,1.f);
+}
+
+LatticeOrigin NoiseBackend::splitLattice(double x, double y) const
+{
+    const double fx = std::floor(x), fy = std::floor(y);
+    LatticeOrigin g;
+    // modulo 2^32 : la periode du reseau depasse toute taille de monde utile
+    g.cx = (int32_t)(uint32_t)(uint64_t)(int64_t)fx;
+    g.cy = (int32_t)(uint32_t)(uint64_t)(int64_t)fy;
+    g.fx = (float)(x - fx);
+    g.fy = (float)(y - fy);
+    return g;
+}
+
+void NoiseBackend::fillWorldOrigin(double originX, double originY, int oct, float lac, WorldOrigin& w) const
+{
+    float freq = 1.f;
+    for(int o=0;o<std::min(oct, kMaxOctaves);o++){
+        w.o[o] = splitLattice(originX*(double)freq, originY*(double)freq);
+        freq*=lac;
+    }
+}
+
+void NoiseBackend::fbmRow(const float* xs, const float* ys, float* out, int n,
+                          int oct, float lac, float gain) const
+{
+    rowKernel(false, oct, lac, gain)(xs, ys, out, n);
+}
+
+void NoiseBackend::ridgedFBMRow(const float* xs, const float* ys, float* out, int n,
+                                int oct, float lac, float gain) const
+{
+    rowKernel(true, oct, lac, gain)(xs, ys, out, n);
+}
+
+std::unique_ptr<NoiseBackend> NoiseBackend::create(NoiseEngine e, uint32_t seed)
+{
+    std::unique_ptr<NoiseBackend> b;
+    switch(e){
+        case NoiseEngine::OpenSimplex2: b = std::make_unique<OpenSimplex2Noise>(); break;
+        case NoiseEngine::Value:        b = std::make_unique<ValueNoise>(); break;
+        default:                        b = std::make_unique<Noise>(); break;
+    }
+    b->init(seed);
+    return b;
+}
+
+const char* NoiseBackend::engineName(NoiseEngine e)
+{
+    switch(e){
+        case NoiseEngine::OpenSimplex2: return "OpenSimplex2";
+        case NoiseEngine::Value:        return "Value";
+        default:                        return "Perlin";
+    }
+}
+
+double NoiseBackend::benchmark(const NoiseBackend& b, bool ridged, int oct, float lac, float gain, int side)
+{
+    side = std::max(16, side);
+    std::vector<float> xs(side), ys(side), out(side);
+    const RowKernel k = b.rowKernel(ridged, oct, lac, gain);
+
+    // meilleur de 3 passes (evite le bruit de la premiere passe a froid)
+    double best = 1e30;
+    float sink = 0.f;
+    for(int pass=0; pass<3; ++pass){
+        auto t0 = std::chrono::steady_clock::now();
+        for(int j=0;j<side;j++){
+            for(int i=0;i<side;i++){ xs[i] = i*0.01f; ys[i] = j*0.01f + 0.003f*i; }
+            k(xs.data(), ys.data(), out.data(), side);
+            sink += out[j % side];
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+    if(sink == 12345.678f) best += 1e-9; // garde le calcul vivant
+
+    return (double)side * (double)side / std::max(1e-9, best) * 1e-6;
+}
+
+} // namespace dune
@@ -0,0 +1,273 @@
+// src/NoiseBackend.h
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+namespace dune {
+
+// Monde etendu (Params::largeWorld) : une coordonnee de bruit est gardee en
+// cellule entiere du reseau (int32, arithmetique modulo 2^32) + fraction
+// float. L'origine du chunk est decoupee une fois par octave en double ; les
+// noyaux ne voient que des offsets locaux de petite amplitude.
+struct LatticeOrigin {
+    int32_t cx = 0, cy = 0;
+    float fx = 0.f, fy = 0.f;
+};
+constexpr int kMaxOctaves = 32; // cf. Params::clampSafety
+
+// Hash entier 32 bits d'un noeud du reseau (Value, Perlin monde etendu)
+inline uint32_t latticeHash(uint32_t seed, int32_t x, int32_t y)
+{
+    uint32_t h = seed ^ ((uint32_t)x * 0x27d4eb2du) ^ ((uint32_t)y * 0x165667b1u);
+    h ^= h >> 15; h *= 0x2c1b3c6du;
+    h ^= h >> 12; h *= 0x297a2d39u;
+    h ^= h >> 15;
+    return h;
+}
+
+// Somme modulo 2^32 (cellule d'origine + cellule locale)
+inline int32_t cellAdd(int32_t a, int32_t b){ return (int32_t)((uint32_t)a + (uint32_t)b); }
+
+// Contexte des noyaux "monde" : ctx du moteur + origine par octave. Fourni
+// par l'appelant, doit survivre au RowKernel qui le reference.
+struct WorldOrigin {
+    const void* base = nullptr;
+    LatticeOrigin o[kMaxOctaves];
+};
+
+// Moteurs de bruit disponibles (Params::noiseEngine)
+enum class NoiseEngine { Perlin = 0, OpenSimplex2 = 1, Value = 2 };
+constexpr int kNoiseEngineCount = 3;
+
+// Interface commune des moteurs de bruit 2D. TerrainGenerator ne passe que
+// par les noyaux "ligne" (rowKernel) ; sample/fbm restent pour les appels
+// ponctuels.
+class NoiseBackend {
+public:
+    virtual ~NoiseBackend() = default;
+
+    virtual NoiseEngine engine() const = 0;
+    virtual void init(uint32_t seed) = 0;
+    // Graine du dernier init()
+    virtual uint32_t seed() const = 0;
+
+    // Bruit de base, ~[-1,1]
+    virtual float sample(float x, float y) const = 0;
+    // Idem + derivees partielles analytiques (valeur identique a sample())
+    virtual float sampleD(float x, float y, float& dx, float& dy) const = 0;
+
+    float fbm(float x,float y,int oct,float lac,float gain) const;
+    float ridgedFBM(float x,float y,int oct,float lac,float gain) const;
+    float fbmD(float x,float y,int oct,float lac,float gain, float& dx, float& dy) const;
+    float ridgedFBMD(float x,float y,int oct,float lac,float gain, float& dx, float& dy) const;
+
+    // Noyau "ligne" specialise a la compilation (mode fbm/ridged, octaves 1..10),
+    // a choisir une fois par chunk puis a appeler pour chaque ligne.
+    struct RowKernel {
+        using Fn = void(*)(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                           int oct, float lac, float gain);
+        // Variante avec gradient : dx/dy = d(out)/dx, d(out)/dy
+        using FnD = void(*)(const void* ctx, const float* xs, const float* ys, float* out,
+                            float* dx, float* dy, int n, int oct, float lac, float gain);
+        Fn fn = nullptr;
+        FnD fnD = nullptr;
+        const void* ctx = nullptr;
+        int oct = 1;
+        float lac = 2.f, gain = 0.5f;
+
+        void operator()(const float* xs, const float* ys, float* out, int n) const
+        { fn(ctx, xs, ys, out, n, oct, lac, gain); }
+        void operator()(const float* xs, const float* ys, float* out, float* dx, float* dy, int n) const
+        { fnD(ctx, xs, ys, out, dx, dy, n, oct, lac, gain); }
+    };
+    virtual RowKernel rowKernel(bool ridged, int oct, float lac, float gain) const = 0;
+
+    // Noyau d'apercu (pendant un drag de slider) : precision reduite, meme
+    // allure que rowKernel. Par defaut : le noyau pleine qualite.
+    virtual RowKernel previewRowKernel(bool ridged, int oct, float lac, float gain) const
+    { return rowKernel(ridged, oct, lac, gain); }
+
+    // Evaluation par lots : out[i] = fbm(xs[i], ys[i], ...) pour i < n.
+    void fbmRow(const float* xs, const float* ys, float* out, int n,
+                int oct, float lac, float gain) const;
+    void ridgedFBMRow(const float* xs, const float* ys, float* out, int n,
+                      int oct, float lac, float gain) const;
+
+    // Noyau monde etendu : out[i] = fbm(origine + (xs[i], ys[i])), origine en
+    // double. Memes Fn/FnD que rowKernel, ctx = `w` (rempli ici). Hash large
+    // (pas de periode a 256 pour Perlin) : le motif differe du mode normal.
+    virtual RowKernel worldRowKernel(bool ridged, int oct, float lac, float gain,
+                                     double originX, double originY, WorldOrigin& w) const = 0;
+
+    // Decoupe (x,y) en cellule + fraction dans le repere du reseau du moteur
+    // (OpenSimplex2 : reseau simplexe, les cellules sont en coordonnees
+    // "skew"). Par defaut : reseau carre.
+    virtual LatticeOrigin splitLattice(double x, double y) const;
+
+    // Remplit w.o[0..oct) : memes frequences float que les noyaux (freq*=lac)
+    void fillWorldOrigin(double originX, double originY, int oct, float lac, WorldOrigin& w) const;
+
+    static std::unique_ptr<NoiseBackend> create(NoiseEngine e, uint32_t seed = 1337);
+    static const char* engineName(NoiseEngine e);
+
+    // Debit du noyau ligne (millions d'echantillons fbm par seconde) sur une
+    // fenetre side x side, memes reglages que rowKernel.
+    static double benchmark(const NoiseBackend& b, bool ridged = false, int oct = 5, float lac = 1.9f,
+                            float gain = 0.45f, int side = 512);
+};
+
+// Octaves specialisees a la compilation par les noyaux ligne
+constexpr int kMaxSpecializedOctaves = 10;
+
+// Noyau ligne generique pour un moteur scalaire : Sample(ctx, x, y).
+// Meme ordre d'operations que NoiseBackend::fbm / ridgedFBM.
+template<float (*Sample)(const void*, float, float), int Oct, bool Ridged>
+void genericRow(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                int oct, float lac, float gain)
+{
+    const int nOct = Oct ? Oct : oct;
+    for(int i=0;i<n;i++){
+        float amp=0.5f,freq=1.f,sum=0;
+        for(int o=0;o<nOct;o++){
+            float p = Sample(ctx, xs[i]*freq, ys[i]*freq);
+            if(Ridged){
+                float r = 1.f - fabsf(p);
+                r*=r;
+                sum += r*amp;
+            }else{
+                sum += amp*p;
+            }
+            freq*=lac; amp*=gain;
+        }
+        out[i] = Ridged ? std::clamp(sum,0.f,1.f) : sum;
+    }
+}
+
+template<float (*Sample)(const void*, float, float)>
+NoiseBackend::RowKernel::Fn genericRowKernel(bool ridged, int oct)
+{
+    static const NoiseBackend::RowKernel::Fn table[2][kMaxSpecializedOctaves+1] = {
+        { genericRow<Sample,0,false>, genericRow<Sample,1,false>, genericRow<Sample,2,false>,
+          genericRow<Sample,3,false>, genericRow<Sample,4,false>, genericRow<Sample,5,false>,
+          genericRow<Sample,6,false>, genericRow<Sample,7,false>, genericRow<Sample,8,false>,
+          genericRow<Sample,9,false>, genericRow<Sample,10,false> },
+        { genericRow<Sample,0,true>,  genericRow<Sample,1,true>,  genericRow<Sample,2,true>,
+          genericRow<Sample,3,true>,  genericRow<Sample,4,true>,  genericRow<Sample,5,true>,
+          genericRow<Sample,6,true>,  genericRow<Sample,7,true>,  genericRow<Sample,8,true>,
+          genericRow<Sample,9,true>,  genericRow<Sample,10,true> }
+    };
+    const int o = (oct >= 1 && oct <= kMaxSpecializedOctaves) ? oct : 0;
+    return table[ridged][o];
+}
+
+// Variante avec gradient (octaves runtime). Ridged : d/dp (1-|p|)^2 =
+// -2(1-|p|)sign(p) ; gradient nul la ou le clamp [0,1] est actif.
+template<float (*SampleD)(const void*, float, float, float&, float&), bool Ridged>
+void genericRowD(const void* ctx, const float* xs, const float* ys, float* out,
+                 float* dxo, float* dyo, int n, int oct, float lac, float gain)
+{
+    for(int i=0;i<n;i++){
+        float amp=0.5f,freq=1.f,sum=0,sx=0,sy=0;
+        for(int o=0;o<oct;o++){
+            float px,py;
+            float p = SampleD(ctx, xs[i]*freq, ys[i]*freq, px, py);
+            if(Ridged){
+                float r = 1.f - fabsf(p);
+                float k = -2.f*r*amp*freq;
+                if(p < 0.f) k = -k;
+                r*=r;
+                sum += r*amp;
+                sx += k*px; sy += k*py;
+            }else{
+                sum += amp*p;
+                sx += amp*freq*px; sy += amp*freq*py;
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged && (sum < 0.f || sum > 1.f)){ sx = 0.f; sy = 0.f; }
+        out[i] = Ridged ? std::clamp(sum,0.f,1.f) : sum;
+        dxo[i] = sx; dyo[i] = sy;
+    }
+}
+
+template<float (*SampleD)(const void*, float, float, float&, float&)>
+NoiseBackend::RowKernel::FnD genericRowKernelD(bool ridged)
+{
+    return ridged ? &genericRowD<SampleD,true> : &genericRowD<SampleD,false>;
+}
+
+// Noyaux monde generiques : SampleW(base, cx, cy, x, y) = bruit a la cellule
+// (cx,cy) + (x,y), x et y petits. ctx = WorldOrigin.
+template<float (*SampleW)(const void*, int32_t, int32_t, float, float), bool Ridged>
+void genericRowW(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                 int oct, float lac, float gain)
+{
+    const WorldOrigin& w = *(const WorldOrigin*)ctx;
+    for(int i=0;i<n;i++){
+        float amp=0.5f,freq=1.f,sum=0;
+        for(int o=0;o<oct;o++){
+            const LatticeOrigin& g = w.o[o];
+            float p = SampleW(w.base, g.cx, g.cy, g.fx + xs[i]*freq, g.fy + ys[i]*freq);
+            if(Ridged){
+                float r = 1.f - fabsf(p);
+                r*=r;
+                sum += r*amp;
+            }else{
+                sum += amp*p;
+            }
+            freq*=lac; amp*=gain;
+        }
+        out[i] = Ridged ? std::clamp(sum,0.f,1.f) : sum;
+    }
+}
+
+template<float (*SampleDW)(const void*, int32_t, int32_t, float, float, float&, float&), bool Ridged>
+void genericRowDW(const void* ctx, const float* xs, const float* ys, float* out,
+                  float* dxo, float* dyo, int n, int oct, float lac, float gain)
+{
+    const WorldOrigin& w = *(const WorldOrigin*)ctx;
+    for(int i=0;i<n;i++){
+        float amp=0.5f,freq=1.f,sum=0,sx=0,sy=0;
+        for(int o=0;o<oct;o++){
+            const LatticeOrigin& g = w.o[o];
+            float px,py;
+            float p = SampleDW(w.base, g.cx, g.cy, g.fx + xs[i]*freq, g.fy + ys[i]*freq, px, py);
+            if(Ridged){
+                float r = 1.f - fabsf(p);
+                float k = -2.f*r*amp*freq;
+                if(p < 0.f) k = -k;
+                r*=r;
+                sum += r*amp;
+                sx += k*px; sy += k*py;
+            }else{
+                sum += amp*p;
+                sx += amp*freq*px; sy += amp*freq*py;
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged && (sum < 0.f || sum > 1.f)){ sx = 0.f; sy = 0.f; }
+        out[i] = Ridged ? std::clamp(sum,0.f,1.f) : sum;
+        dxo[i] = sx; dyo[i] = sy;
+    }
+}
+
+template<float (*SampleW)(const void*, int32_t, int32_t, float, float),
+         float (*SampleDW)(const void*, int32_t, int32_t, float, float, float&, float&)>
+NoiseBackend::RowKernel genericWorldKernel(const NoiseBackend& b, const void* base,
+                                           bool ridged, int oct, float lac, float gain,
+                                           double originX, double originY, WorldOrigin& w)
+{
+    w.base = base;
+    b.fillWorldOrigin(originX, originY, oct, lac, w);
+    NoiseBackend::RowKernel k;
+    k.fn  = ridged ? &genericRowW<SampleW,true>   : &genericRowW<SampleW,false>;
+    k.fnD = ridged ? &genericRowDW<SampleDW,true> : &genericRowDW<SampleDW,false>;
+    k.ctx = &w;
+    k.oct = std::min(oct, kMaxOctaves); k.lac = lac; k.gain = gain;
+    return k;
+}
+
+} // namespace dune
@@ -0,0 +1,1290 @@
+// src/NoiseSimd.cpp
+#include "NoiseSimd.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #define DUNE_SIMD_X86 1
+  #include <immintrin.h>
+  #if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #define DUNE_TARGET_SSE41
+    #define DUNE_TARGET_AVX2
+    #define DUNE_TARGET_AVX512
+    #define DUNE_TARGET_AVX512BW
+  #else
+    // avx512f implique fma chez GCC : ce fichier est compile avec
+    // -ffp-contract=off (voir CMakeLists.txt) pour rester identique au scalaire.
+    #define DUNE_TARGET_SSE41  __attribute__((target("sse4.1")))
+    #define DUNE_TARGET_AVX2   __attribute__((target("avx2")))
+    #define DUNE_TARGET_AVX512 __attribute__((target("avx512f")))
+    #define DUNE_TARGET_AVX512BW __attribute__((target("avx512f,avx512bw")))
+  #endif
+#else
+  #define DUNE_SIMD_X86 0
+#endif
+
+namespace dune {
+namespace simd {
+
+#if DUNE_SIMD_X86
+
+// ---------------------------------------------------------------------------
+// Detection
+
+SimdLevel detectLevel()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuid(r, 0);
+    const int maxLeaf = r[0];
+    __cpuid(r, 1);
+    const bool sse41 = (r[2] & (1<<19)) != 0;
+    const bool osxsave = (r[2] & (1<<27)) != 0;
+    const bool avx = (r[2] & (1<<28)) != 0;
+    if(!sse41) return SimdLevel::Scalar;
+    if(!osxsave || !avx) return SimdLevel::SSE41;
+
+    unsigned long long xcr0 = _xgetbv(0);
+    if((xcr0 & 0x6) != 0x6 || maxLeaf < 7) return SimdLevel::SSE41;
+
+    __cpuidex(r, 7, 0);
+    const bool avx2 = (r[1] & (1<<5)) != 0;
+    const bool avx512f = (r[1] & (1<<16)) != 0;
+    if(avx512f && (xcr0 & 0xE6) == 0xE6) return SimdLevel::AVX512;
+    if(avx2) return SimdLevel::AVX2;
+    return SimdLevel::SSE41;
+#else
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if(__builtin_cpu_supports("avx2"))    return SimdLevel::AVX2;
+    if(__builtin_cpu_supports("sse4.1"))  return SimdLevel::SSE41;
+    return SimdLevel::Scalar;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// SSE4.1 : 4 voies, pas de gather materiel -> lectures scalaires de la table
+
+DUNE_TARGET_SSE41 static inline __m128 fade4(__m128 t)
+{
+    __m128 a = _mm_mul_ps(t, _mm_set1_ps(6.f));
+    a = _mm_sub_ps(a, _mm_set1_ps(15.f));
+    a = _mm_mul_ps(a, t);
+    a = _mm_add_ps(a, _mm_set1_ps(10.f));
+    __m128 t3 = _mm_mul_ps(_mm_mul_ps(t, t), t);
+    return _mm_mul_ps(t3, a);
+}
+
+DUNE_TARGET_SSE41 static inline __m128 grad4(__m128i h, __m128 x, __m128 y)
+{
+    h = _mm_and_si128(h, _mm_set1_epi32(7));
+    __m128 lt4 = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(4)), _mm_setzero_si128()));
+    __m128 u = _mm_blendv_ps(y, x, lt4);
+    __m128 v = _mm_blendv_ps(x, y, lt4);
+    __m128 su = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31));
+    __m128 sv = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30));
+    v = _mm_mul_ps(_mm_set1_ps(2.f), v);
+    return _mm_add_ps(_mm_xor_ps(u, su), _mm_xor_ps(v, sv));
+}
+
+DUNE_TARGET_SSE41 static inline __m128i gather4(const int* perm, __m128i idx)
+{
+    alignas(16) int i[4];
+    _mm_store_si128((__m128i*)i, idx);
+    return _mm_setr_epi32(perm[i[0]], perm[i[1]], perm[i[2]], perm[i[3]]);
+}
+
+DUNE_TARGET_SSE41 static inline __m128 perlin4(const int* perm, __m128 x, __m128 y, CellCache& c)
+{
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128i m255 = _mm_set1_epi32(255);
+    const __m128i i1 = _mm_set1_epi32(1);
+
+    __m128 fx = _mm_floor_ps(x), fy = _mm_floor_ps(y);
+    __m128i X = _mm_and_si128(_mm_cvttps_epi32(fx), m255);
+    __m128i Y = _mm_and_si128(_mm_cvttps_epi32(fy), m255);
+    x = _mm_sub_ps(x, fx); y = _mm_sub_ps(y, fy);
+    __m128 u = fade4(x), v = fade4(y);
+
+    __m128 xm = _mm_sub_ps(x, one), ym = _mm_sub_ps(y, one);
+    __m128 g00, g10, g01, g11;
+
+    const int X0 = _mm_cvtsi128_si32(X), Y0 = _mm_cvtsi128_si32(Y);
+    __m128i same = _mm_and_si128(_mm_cmpeq_epi32(X, _mm_set1_epi32(X0)), _mm_cmpeq_epi32(Y, _mm_set1_epi32(Y0)));
+    if(_mm_movemask_epi8(same) == 0xFFFF){
+        if(X0 != c.X || Y0 != c.Y) fillCell(perm, X0, Y0, c);
+        g00 = _mm_add_ps(_mm_mul_ps(x,  _mm_set1_ps(c.gx[0])), _mm_mul_ps(y,  _mm_set1_ps(c.gy[0])));
+        g10 = _mm_add_ps(_mm_mul_ps(xm, _mm_set1_ps(c.gx[1])), _mm_mul_ps(y,  _mm_set1_ps(c.gy[1])));
+        g01 = _mm_add_ps(_mm_mul_ps(x,  _mm_set1_ps(c.gx[2])), _mm_mul_ps(ym, _mm_set1_ps(c.gy[2])));
+        g11 = _mm_add_ps(_mm_mul_ps(xm, _mm_set1_ps(c.gx[3])), _mm_mul_ps(ym, _mm_set1_ps(c.gy[3])));
+    }else{
+        __m128i A = _mm_add_epi32(gather4(perm, X), Y);
+        __m128i B = _mm_add_epi32(gather4(perm, _mm_add_epi32(X, i1)), Y);
+        g00 = grad4(gather4(perm, A), x, y);
+        g10 = grad4(gather4(perm, B), xm, y);
+        g01 = grad4(gather4(perm, _mm_add_epi32(A, i1)), x, ym);
+        g11 = grad4(gather4(perm, _mm_add_epi32(B, i1)), xm, ym);
+    }
+
+    __m128 l0 = _mm_add_ps(g00, _mm_mul_ps(u, _mm_sub_ps(g10, g00)));
+    __m128 l1 = _mm_add_ps(g01, _mm_mul_ps(u, _mm_sub_ps(g11, g01)));
+    return _mm_add_ps(l0, _mm_mul_ps(v, _mm_sub_ps(l1, l0)));
+}
+
+template<int Oct, bool Ridged>
+DUNE_TARGET_SSE41 static void fbmRowSSE41(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                                          int oct, float lac, float gain)
+{
+    const int* perm = (const int*)ctx;
+    const int nOct = Oct ? Oct : oct; // Oct > 0 : boucle deroulee a la compilation
+    CellCache cache[kCellCaches];
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    for(int i=0;i<n;i+=4){
+        const int cnt = std::min(4, n-i);
+        alignas(16) float bx[4], by[4], bo[4];
+        for(int k=0;k<4;k++){ int s = i + std::min(k, cnt-1); bx[k]=xs[s]; by[k]=ys[s]; }
+
+        __m128 x = _mm_load_ps(bx), y = _mm_load_ps(by);
+        __m128 sum = _mm_setzero_ps();
+        float amp=0.5f, freq=1.f;
+        for(int o=0;o<nOct;o++){
+            __m128 f = _mm_set1_ps(freq), a = _mm_set1_ps(amp);
+            __m128 p = perlin4(perm, _mm_mul_ps(x, f), _mm_mul_ps(y, f), cache[o & (kCellCaches-1)]);
+            if(Ridged){
+                __m128 r = _mm_sub_ps(one, _mm_and_ps(p, absMask));
+                r = _mm_mul_ps(r, r);
+                sum = _mm_add_ps(sum, _mm_mul_ps(r, a));
+            }else{
+                sum = _mm_add_ps(sum, _mm_mul_ps(a, p));
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged) sum = _mm_min_ps(_mm_max_ps(sum, _mm_setzero_ps()), one);
+
+        _mm_store_ps(bo, sum);
+        for(int k=0;k<cnt;k++) out[i+k] = bo[k];
+    }
+}
+
+// --- apercu int16 (8 voies par registre, cf. perlinQ12) ---
+
+DUNE_TARGET_SSE41 static inline __m128i fadeQ8(__m128i q)
+{
+    __m128i f2 = _mm_mulhrs_epi16(q, q), f3 = _mm_mulhrs_epi16(f2, q);
+    __m128i t = _mm_sub_epi16(f2, f3);
+    return _mm_adds_epi16(f2, _mm_adds_epi16(t, t));
+}
+
+// codes h (3 bits) -> gx, gy dans {+-1,+-2} (cf. fillPreviewCell)
+DUNE_TARGET_SSE41 static inline void gradXYQ8(__m128i h, __m128i& gx, __m128i& gy)
+{
+    __m128i sw = _mm_cmpeq_epi16(_mm_and_si128(h, _mm_set1_epi16(4)), _mm_set1_epi16(4));
+    __m128i s1 = _mm_sub_epi16(_mm_set1_epi16(1), _mm_slli_epi16(_mm_and_si128(h, _mm_set1_epi16(1)), 1));
+    __m128i s2 = _mm_sub_epi16(_mm_set1_epi16(2), _mm_slli_epi16(_mm_and_si128(h, _mm_set1_epi16(2)), 1));
+    gx = _mm_blendv_epi8(s1, s2, sw);
+    gy = _mm_blendv_epi8(s2, s1, sw);
+}
+
+DUNE_TARGET_SSE41 static inline __m128i perlinQ8(const __m128i* gx, const __m128i* gy, __m128i qx, __m128i qy)
+{
+    const __m128i one = _mm_set1_epi16(4096);
+    __m128i u = fadeQ8(qx), v = fadeQ8(qy);
+    __m128i x = _mm_srai_epi16(qx, 3), y = _mm_srai_epi16(qy, 3);
+    __m128i xm = _mm_sub_epi16(x, one), ym = _mm_sub_epi16(y, one);
+    __m128i g00 = _mm_add_epi16(_mm_mullo_epi16(x,  gx[0]), _mm_mullo_epi16(y,  gy[0]));
+    __m128i g10 = _mm_add_epi16(_mm_mullo_epi16(xm, gx[1]), _mm_mullo_epi16(y,  gy[1]));
+    __m128i g01 = _mm_add_epi16(_mm_mullo_epi16(x,  gx[2]), _mm_mullo_epi16(ym, gy[2]));
+    __m128i g11 = _mm_add_epi16(_mm_mullo_epi16(xm, gx[3]), _mm_mullo_epi16(ym, gy[3]));
+    __m128i l0 = _mm_add_epi16(g00, _mm_mulhrs_epi16(u, _mm_sub_epi16(g10, g00)));
+    __m128i l1 = _mm_add_epi16(g01, _mm_mulhrs_epi16(u, _mm_sub_epi16(g11, g01)));
+    return _mm_add_epi16(l0, _mm_mulhrs_epi16(v, _mm_sub_epi16(l1, l0)));
+}
+
+// 4 voies float -> cellule (X | Y<<8) et fractions Q15 (int32)
+DUNE_TARGET_SSE41 static inline void latticeQ4(__m128 x, __m128 y, __m128i& cell, __m128i& qx, __m128i& qy)
+{
+    const __m128i m255 = _mm_set1_epi32(255), qmax = _mm_set1_epi32(32767);
+    const __m128 s = _mm_set1_ps(32768.f);
+    __m128 fx = _mm_floor_ps(x), fy = _mm_floor_ps(y);
+    __m128i X = _mm_and_si128(_mm_cvttps_epi32(fx), m255);
+    __m128i Y = _mm_and_si128(_mm_cvttps_epi32(fy), m255);
+    cell = _mm_or_si128(X, _mm_slli_epi32(Y, 8));
+    qx = _mm_min_epi32(_mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(x, fx), s)), qmax);
+    qy = _mm_min_epi32(_mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(y, fy), s)), qmax);
+}
+
+// Gradients des 8 voies : constantes de la PreviewCell si toutes les voies
+// tombent dans la meme cellule, sinon lectures scalaires de la table.
+DUNE_TARGET_SSE41 static inline void cellGradsQ8(const uint16_t* cells, __m128i c0, __m128i c1, PreviewCell& pc,
+                                                 __m128i* gx, __m128i* gy)
+{
+    const int cell0 = _mm_cvtsi128_si32(c0);
+    const __m128i b = _mm_set1_epi32(cell0);
+    const __m128i same = _mm_and_si128(_mm_cmpeq_epi32(c0, b), _mm_cmpeq_epi32(c1, b));
+    if(_mm_movemask_epi8(same) == 0xFFFF){
+        if(cell0 != pc.cell) fillPreviewCell(cell0, cells[cell0], pc);
+        for(int k=0;k<4;k++){ gx[k] = _mm_set1_epi16(pc.gx[k]); gy[k] = _mm_set1_epi16(pc.gy[k]); }
+        return;
+    }
+    alignas(16) int ci[8];
+    _mm_store_si128((__m128i*)ci, c0); _mm_store_si128((__m128i*)(ci+4), c1);
+    __m128i code = _mm_setr_epi16((short)cells[ci[0]], (short)cells[ci[1]], (short)cells[ci[2]], (short)cells[ci[3]],
+                                  (short)cells[ci[4]], (short)cells[ci[5]], (short)cells[ci[6]], (short)cells[ci[7]]);
+    const __m128i m7 = _mm_set1_epi16(7);
+    for(int k=0;k<4;k++) gradXYQ8(_mm_and_si128(_mm_srli_epi16(code, 3*k), m7), gx[k], gy[k]);
+}
+
+template<bool Ridged>
+DUNE_TARGET_SSE41 static void previewRowSSE41(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                                              int oct, float lac, float gain)
+{
+    const uint16_t* cells = (const uint16_t*)ctx;
+    PreviewCell cache[kCellCaches];
+    for(int i=0;i<n;i+=8){
+        const int cnt = std::min(8, n-i);
+        __m128 x0, x1, y0, y1;
+        if(cnt == 8){
+            x0 = _mm_loadu_ps(xs+i); x1 = _mm_loadu_ps(xs+i+4);
+            y0 = _mm_loadu_ps(ys+i); y1 = _mm_loadu_ps(ys+i+4);
+        }else{
+            alignas(16) float bx[8], by[8];
+            for(int k=0;k<8;k++){ int s = i + std::min(k, cnt-1); bx[k]=xs[s]; by[k]=ys[s]; }
+            x0 = _mm_load_ps(bx); x1 = _mm_load_ps(bx+4);
+            y0 = _mm_load_ps(by); y1 = _mm_load_ps(by+4);
+        }
+
+        __m128i sum = _mm_setzero_si128();
+        float amp=0.5f, freq=1.f;
+        for(int o=0;o<oct;o++){
+            __m128 f = _mm_set1_ps(freq);
+            __m128i c0, c1, qx0, qx1, qy0, qy1, gx[4], gy[4];
+            latticeQ4(_mm_mul_ps(x0, f), _mm_mul_ps(y0, f), c0, qx0, qy0);
+            latticeQ4(_mm_mul_ps(x1, f), _mm_mul_ps(y1, f), c1, qx1, qy1);
+            cellGradsQ8(cells, c0, c1, cache[o & (kCellCaches-1)], gx, gy);
+            __m128i p = perlinQ8(gx, gy, _mm_packs_epi32(qx0, qx1), _mm_packs_epi32(qy0, qy1));
+            __m128i a = _mm_set1_epi16((short)std::min(32767, (int)(amp*32768.f)));
+            if(Ridged){
+                __m128i r = _mm_sub_epi16(_mm_set1_epi16(4096), _mm_abs_epi16(p));
+                __m128i r2 = _mm_mulhrs_epi16(r, _mm_slli_epi16(r, 2));
+                r2 = _mm_add_epi16(r2, r2);
+                sum = _mm_adds_epi16(sum, _mm_mulhrs_epi16(r2, a));
+            }else{
+                sum = _mm_adds_epi16(sum, _mm_mulhrs_epi16(p, a));
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged) sum = _mm_min_epi16(_mm_max_epi16(sum, _mm_setzero_si128()), _mm_set1_epi16(4096));
+
+        const __m128 k = _mm_set1_ps(1.f/4096.f);
+        __m128 o0 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(sum)), k);
+        __m128 o1 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(sum, 8))), k);
+        if(cnt == 8){
+            _mm_storeu_ps(out+i, o0); _mm_storeu_ps(out+i+4, o1);
+        }else{
+            alignas(16) float bo[8];
+            _mm_store_ps(bo, o0); _mm_store_ps(bo+4, o1);
+            for(int k2=0;k2<cnt;k2++) out[i+k2] = bo[k2];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 : 8 voies, gathers materiels
+
+DUNE_TARGET_AVX2 static inline __m256 fade8(__m256 t)
+{
+    __m256 a = _mm256_mul_ps(t, _mm256_set1_ps(6.f));
+    a = _mm256_sub_ps(a, _mm256_set1_ps(15.f));
+    a = _mm256_mul_ps(a, t);
+    a = _mm256_add_ps(a, _mm256_set1_ps(10.f));
+    __m256 t3 = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+    return _mm256_mul_ps(t3, a);
+}
+
+DUNE_TARGET_AVX2 static inline __m256 grad8(__m256i h, __m256 x, __m256 y)
+{
+    h = _mm256_and_si256(h, _mm256_set1_epi32(7));
+    __m256 lt4 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(4)), _mm256_setzero_si256()));
+    __m256 u = _mm256_blendv_ps(y, x, lt4);
+    __m256 v = _mm256_blendv_ps(x, y, lt4);
+    __m256 su = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+    __m256 sv = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+    v = _mm256_mul_ps(_mm256_set1_ps(2.f), v);
+    return _mm256_add_ps(_mm256_xor_ps(u, su), _mm256_xor_ps(v, sv));
+}
+
+DUNE_TARGET_AVX2 static inline __m256 perlin8(const int* perm, __m256 x, __m256 y, CellCache& c)
+{
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256i m255 = _mm256_set1_epi32(255);
+    const __m256i i1 = _mm256_set1_epi32(1);
+
+    __m256 fx = _mm256_floor_ps(x), fy = _mm256_floor_ps(y);
+    __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(fx), m255);
+    __m256i Y = _mm256_and_si256(_mm256_cvttps_epi32(fy), m255);
+    x = _mm256_sub_ps(x, fx); y = _mm256_sub_ps(y, fy);
+    __m256 u = fade8(x), v = fade8(y);
+
+    __m256 xm = _mm256_sub_ps(x, one), ym = _mm256_sub_ps(y, one);
+    __m256 g00, g10, g01, g11;
+
+    const int X0 = _mm256_cvtsi256_si32(X), Y0 = _mm256_cvtsi256_si32(Y);
+    __m256i same = _mm256_and_si256(_mm256_cmpeq_epi32(X, _mm256_set1_epi32(X0)), _mm256_cmpeq_epi32(Y, _mm256_set1_epi32(Y0)));
+    if(_mm256_movemask_epi8(same) == -1){
+        if(X0 != c.X || Y0 != c.Y) fillCell(perm, X0, Y0, c);
+        g00 = _mm256_add_ps(_mm256_mul_ps(x,  _mm256_set1_ps(c.gx[0])), _mm256_mul_ps(y,  _mm256_set1_ps(c.gy[0])));
+        g10 = _mm256_add_ps(_mm256_mul_ps(xm, _mm256_set1_ps(c.gx[1])), _mm256_mul_ps(y,  _mm256_set1_ps(c.gy[1])));
+        g01 = _mm256_add_ps(_mm256_mul_ps(x,  _mm256_set1_ps(c.gx[2])), _mm256_mul_ps(ym, _mm256_set1_ps(c.gy[2])));
+        g11 = _mm256_add_ps(_mm256_mul_ps(xm, _mm256_set1_ps(c.gx[3])), _mm256_mul_ps(ym, _mm256_set1_ps(c.gy[3])));
+    }else{
+        __m256i A = _mm256_add_epi32(_mm256_i32gather_epi32(perm, X, 4), Y);
+        __m256i B = _mm256_add_epi32(_mm256_i32gather_epi32(perm, _mm256_add_epi32(X, i1), 4), Y);
+        g00 = grad8(_mm256_i32gather_epi32(perm, A, 4), x, y);
+        g10 = grad8(_mm256_i32gather_epi32(perm, B, 4), xm, y);
+        g01 = grad8(_mm256_i32gather_epi32(perm, _mm256_add_epi32(A, i1), 4), x, ym);
+        g11 = grad8(_mm256_i32gather_epi32(perm, _mm256_add_epi32(B, i1), 4), xm, ym);
+    }
+
+    __m256 l0 = _mm256_add_ps(g00, _mm256_mul_ps(u, _mm256_sub_ps(g10, g00)));
+    __m256 l1 = _mm256_add_ps(g01, _mm256_mul_ps(u, _mm256_sub_ps(g11, g01)));
+    return _mm256_add_ps(l0, _mm256_mul_ps(v, _mm256_sub_ps(l1, l0)));
+}
+
+template<int Oct, bool Ridged>
+DUNE_TARGET_AVX2 static void fbmRowAVX2(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                                        int oct, float lac, float gain)
+{
+    const int* perm = (const int*)ctx;
+    const int nOct = Oct ? Oct : oct; // Oct > 0 : boucle deroulee a la compilation
+    CellCache cache[kCellCaches];
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+    for(int i=0;i<n;i+=8){
+        const int cnt = std::min(8, n-i);
+        __m256 x, y;
+        if(cnt == 8){
+            x = _mm256_loadu_ps(xs+i); y = _mm256_loadu_ps(ys+i);
+        }else{
+            alignas(32) float bx[8], by[8];
+            for(int k=0;k<8;k++){ int s = i + std::min(k, cnt-1); bx[k]=xs[s]; by[k]=ys[s]; }
+            x = _mm256_load_ps(bx); y = _mm256_load_ps(by);
+        }
+
+        __m256 sum = _mm256_setzero_ps();
+        float amp=0.5f, freq=1.f;
+        for(int o=0;o<nOct;o++){
+            __m256 f = _mm256_set1_ps(freq), a = _mm256_set1_ps(amp);
+            __m256 p = perlin8(perm, _mm256_mul_ps(x, f), _mm256_mul_ps(y, f), cache[o & (kCellCaches-1)]);
+            if(Ridged){
+                __m256 r = _mm256_sub_ps(one, _mm256_and_ps(p, absMask));
+                r = _mm256_mul_ps(r, r);
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(r, a));
+            }else{
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(a, p));
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged) sum = _mm256_min_ps(_mm256_max_ps(sum, _mm256_setzero_ps()), one);
+
+        if(cnt == 8){
+            _mm256_storeu_ps(out+i, sum);
+        }else{
+            alignas(32) float bo[8];
+            _mm256_store_ps(bo, sum);
+            for(int k=0;k<cnt;k++) out[i+k] = bo[k];
+        }
+    }
+}
+
+// --- derivees analytiques (valeur identique a perlin8) ---
+
+DUNE_TARGET_AVX2 static inline __m256 dfade8(__m256 t)
+{
+    // fade'(t) = 30 t^2 (t-1)^2
+    __m256 tm = _mm256_sub_ps(t, _mm256_set1_ps(1.f));
+    __m256 a = _mm256_mul_ps(_mm256_mul_ps(t, t), _mm256_mul_ps(tm, tm));
+    return _mm256_mul_ps(_mm256_set1_ps(30.f), a);
+}
+
+// grad(h,x,y) == gx*x + gy*y (gx,gy dans {+-1,+-2}), cf. fillCell
+DUNE_TARGET_AVX2 static inline void gradXY8(__m256i h, __m256& gx, __m256& gy)
+{
+    h = _mm256_and_si256(h, _mm256_set1_epi32(7));
+    __m256 lt4 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(4)), _mm256_setzero_si256()));
+    __m256 s1 = _mm256_xor_ps(_mm256_set1_ps(1.f), _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31)));
+    __m256 s2 = _mm256_xor_ps(_mm256_set1_ps(2.f), _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30)));
+    gx = _mm256_blendv_ps(s2, s1, lt4);
+    gy = _mm256_blendv_ps(s1, s2, lt4);
+}
+
+DUNE_TARGET_AVX2 static inline __m256 perlin8D(const int* perm, __m256 x, __m256 y, CellCache& c,
+                                               __m256& dx, __m256& dy)
+{
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256i m255 = _mm256_set1_epi32(255);
+    const __m256i i1 = _mm256_set1_epi32(1);
+
+    __m256 fx = _mm256_floor_ps(x), fy = _mm256_floor_ps(y);
+    __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(fx), m255);
+    __m256i Y = _mm256_and_si256(_mm256_cvttps_epi32(fy), m255);
+    x = _mm256_sub_ps(x, fx); y = _mm256_sub_ps(y, fy);
+    __m256 u = fade8(x), v = fade8(y);
+    __m256 du = dfade8(x), dv = dfade8(y);
+
+    __m256 xm = _mm256_sub_ps(x, one), ym = _mm256_sub_ps(y, one);
+    __m256 gx[4], gy[4];
+
+    const int X0 = _mm256_cvtsi256_si32(X), Y0 = _mm256_cvtsi256_si32(Y);
+    __m256i same = _mm256_and_si256(_mm256_cmpeq_epi32(X, _mm256_set1_epi32(X0)), _mm256_cmpeq_epi32(Y, _mm256_set1_epi32(Y0)));
+    if(_mm256_movemask_epi8(same) == -1){
+        if(X0 != c.X || Y0 != c.Y) fillCell(perm, X0, Y0, c);
+        for(int k=0;k<4;k++){ gx[k] = _mm256_set1_ps(c.gx[k]); gy[k] = _mm256_set1_ps(c.gy[k]); }
+    }else{
+        __m256i A = _mm256_add_epi32(_mm256_i32gather_epi32(perm, X, 4), Y);
+        __m256i B = _mm256_add_epi32(_mm256_i32gather_epi32(perm, _mm256_add_epi32(X, i1), 4), Y);
+        gradXY8(_mm256_i32gather_epi32(perm, A, 4), gx[0], gy[0]);
+        gradXY8(_mm256_i32gather_epi32(perm, B, 4), gx[1], gy[1]);
+        gradXY8(_mm256_i32gather_epi32(perm, _mm256_add_epi32(A, i1), 4), gx[2], gy[2]);
+        gradXY8(_mm256_i32gather_epi32(perm, _mm256_add_epi32(B, i1), 4), gx[3], gy[3]);
+    }
+
+    __m256 g00 = _mm256_add_ps(_mm256_mul_ps(x,  gx[0]), _mm256_mul_ps(y,  gy[0]));
+    __m256 g10 = _mm256_add_ps(_mm256_mul_ps(xm, gx[1]), _mm256_mul_ps(y,  gy[1]));
+    __m256 g01 = _mm256_add_ps(_mm256_mul_ps(x,  gx[2]), _mm256_mul_ps(ym, gy[2]));
+    __m256 g11 = _mm256_add_ps(_mm256_mul_ps(xm, gx[3]), _mm256_mul_ps(ym, gy[3]));
+
+    __m256 l0 = _mm256_add_ps(g00, _mm256_mul_ps(u, _mm256_sub_ps(g10, g00)));
+    __m256 l1 = _mm256_add_ps(g01, _mm256_mul_ps(u, _mm256_sub_ps(g11, g01)));
+
+    // n = a + u(b-a) + v(c-a) + uv(a-b-c+d)
+    __m256 k1 = _mm256_sub_ps(g10, g00);
+    __m256 k2 = _mm256_sub_ps(g01, g00);
+    __m256 k3 = _mm256_add_ps(_mm256_sub_ps(_mm256_sub_ps(g00, g10), g01), g11);
+    __m256 uv = _mm256_mul_ps(u, v);
+
+    __m256 ex = _mm256_add_ps(_mm256_sub_ps(_mm256_sub_ps(gx[0], gx[1]), gx[2]), gx[3]);
+    dx = _mm256_add_ps(gx[0], _mm256_mul_ps(u, _mm256_sub_ps(gx[1], gx[0])));
+    dx = _mm256_add_ps(dx, _mm256_mul_ps(v, _mm256_sub_ps(gx[2], gx[0])));
+    dx = _mm256_add_ps(dx, _mm256_mul_ps(uv, ex));
+    dx = _mm256_add_ps(dx, _mm256_mul_ps(du, _mm256_add_ps(k1, _mm256_mul_ps(v, k3))));
+
+    __m256 ey = _mm256_add_ps(_mm256_sub_ps(_mm256_sub_ps(gy[0], gy[1]), gy[2]), gy[3]);
+    dy = _mm256_add_ps(gy[0], _mm256_mul_ps(u, _mm256_sub_ps(gy[1], gy[0])));
+    dy = _mm256_add_ps(dy, _mm256_mul_ps(v, _mm256_sub_ps(gy[2], gy[0])));
+    dy = _mm256_add_ps(dy, _mm256_mul_ps(uv, ey));
+    dy = _mm256_add_ps(dy, _mm256_mul_ps(dv, _mm256_add_ps(k2, _mm256_mul_ps(u, k3))));
+
+    return _mm256_add_ps(l0, _mm256_mul_ps(v, _mm256_sub_ps(l1, l0)));
+}
+
+template<bool Ridged>
+DUNE_TARGET_AVX2 static void fbmRowDAVX2(const void* ctx, const float* xs, const float* ys, float* out,
+                                          float* dxo, float* dyo, int n, int oct, float lac, float gain)
+{
+    const int* perm = (const int*)ctx;
+    CellCache cache[kCellCaches];
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+
+    for(int i=0;i<n;i+=8){
+        const int cnt = std::min(8, n-i);
+        alignas(32) float bx[8], by[8];
+        for(int k=0;k<8;k++){ int s = i + std::min(k, cnt-1); bx[k]=xs[s]; by[k]=ys[s]; }
+        __m256 x = _mm256_load_ps(bx), y = _mm256_load_ps(by);
+
+        __m256 sum = zero, sx = zero, sy = zero;
+        float amp=0.5f, freq=1.f;
+        for(int o=0;o<oct;o++){
+            __m256 f = _mm256_set1_ps(freq), a = _mm256_set1_ps(amp);
+            __m256 dpx, dpy;
+            __m256 p = perlin8D(perm, _mm256_mul_ps(x, f), _mm256_mul_ps(y, f), cache[o & (kCellCaches-1)], dpx, dpy);
+            if(Ridged){
+                __m256 q = _mm256_sub_ps(one, _mm256_andnot_ps(signMask, p));
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_mul_ps(q, q), a));
+                // d(q^2)/dp = -2 q sign(p)
+                __m256 k = _mm256_mul_ps(q, _mm256_set1_ps(-2.f*amp*freq));
+                k = _mm256_xor_ps(k, _mm256_and_ps(p, signMask));
+                sx = _mm256_add_ps(sx, _mm256_mul_ps(k, dpx));
+                sy = _mm256_add_ps(sy, _mm256_mul_ps(k, dpy));
+            }else{
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(a, p));
+                __m256 k = _mm256_set1_ps(amp*freq);
+                sx = _mm256_add_ps(sx, _mm256_mul_ps(k, dpx));
+                sy = _mm256_add_ps(sy, _mm256_mul_ps(k, dpy));
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged){
+            // derivee nulle la ou le clamp mord
+            __m256 in = _mm256_and_ps(_mm256_cmp_ps(sum, zero, _CMP_GE_OQ), _mm256_cmp_ps(sum, one, _CMP_LE_OQ));
+            sx = _mm256_and_ps(sx, in); sy = _mm256_and_ps(sy, in);
+            sum = _mm256_min_ps(_mm256_max_ps(sum, zero), one);
+        }
+
+        alignas(32) float bo[8], bdx[8], bdy[8];
+        _mm256_store_ps(bo, sum); _mm256_store_ps(bdx, sx); _mm256_store_ps(bdy, sy);
+        for(int k=0;k<cnt;k++){ out[i+k] = bo[k]; dxo[i+k] = bdx[k]; dyo[i+k] = bdy[k]; }
+    }
+}
+
+// --- monde etendu : gradients hashes (latticeHash), pas de gather ---
+
+DUNE_TARGET_AVX2 static inline __m256i hashCode8(__m256i seed, __m256i xh, __m256i yh)
+{
+    __m256i h = _mm256_xor_si256(seed, _mm256_xor_si256(xh, yh));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15)); h = _mm256_mullo_epi32(h, _mm256_set1_epi32(0x2c1b3c6d));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 12)); h = _mm256_mullo_epi32(h, _mm256_set1_epi32(0x297a2d39));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+    return _mm256_srli_epi32(h, 29);
+}
+
+DUNE_TARGET_AVX2 static inline __m256 perlin8W(uint32_t seed, const LatticeOrigin& g, __m256 x, __m256 y, CellCache& c)
+{
+    const __m256 one = _mm256_set1_ps(1.f);
+
+    __m256 fx = _mm256_floor_ps(x), fy = _mm256_floor_ps(y);
+    __m256i X = _mm256_add_epi32(_mm256_set1_epi32(g.cx), _mm256_cvttps_epi32(fx));
+    __m256i Y = _mm256_add_epi32(_mm256_set1_epi32(g.cy), _mm256_cvttps_epi32(fy));
+    x = _mm256_sub_ps(x, fx); y = _mm256_sub_ps(y, fy);
+    __m256 u = fade8(x), v = fade8(y);
+
+    __m256 xm = _mm256_sub_ps(x, one), ym = _mm256_sub_ps(y, one);
+    __m256 g00, g10, g01, g11;
+
+    const int X0 = _mm256_cvtsi256_si32(X), Y0 = _mm256_cvtsi256_si32(Y);
+    __m256i same = _mm256_and_si256(_mm256_cmpeq_epi32(X, _mm256_set1_epi32(X0)), _mm256_cmpeq_epi32(Y, _mm256_set1_epi32(Y0)));
+    if(_mm256_movemask_epi8(same) == -1){
+        if(X0 != c.X || Y0 != c.Y) fillCellHashed(seed, X0, Y0, c);
+        g00 = _mm256_add_ps(_mm256_mul_ps(x,  _mm256_set1_ps(c.gx[0])), _mm256_mul_ps(y,  _mm256_set1_ps(c.gy[0])));
+        g10 = _mm256_add_ps(_mm256_mul_ps(xm, _mm256_set1_ps(c.gx[1])), _mm256_mul_ps(y,  _mm256_set1_ps(c.gy[1])));
+        g01 = _mm256_add_ps(_mm256_mul_ps(x,  _mm256_set1_ps(c.gx[2])), _mm256_mul_ps(ym, _mm256_set1_ps(c.gy[2])));
+        g11 = _mm256_add_ps(_mm256_mul_ps(xm, _mm256_set1_ps(c.gx[3])), _mm256_mul_ps(ym, _mm256_set1_ps(c.gy[3])));
+    }else{
+        // (X+1)*k == X*k + k : 2 multiplications pour les 4 coins
+        const __m256i kx = _mm256_set1_epi32(0x27d4eb2d), ky = _mm256_set1_epi32(0x165667b1);
+        const __m256i sd = _mm256_set1_epi32((int)seed);
+        __m256i x0 = _mm256_mullo_epi32(X, kx), x1 = _mm256_add_epi32(x0, kx);
+        __m256i y0 = _mm256_mullo_epi32(Y, ky), y1 = _mm256_add_epi32(y0, ky);
+        g00 = grad8(hashCode8(sd, x0, y0), x, y);
+        g10 = grad8(hashCode8(sd, x1, y0), xm, y);
+        g01 = grad8(hashCode8(sd, x0, y1), x, ym);
+        g11 = grad8(hashCode8(sd, x1, y1), xm, ym);
+    }
+
+    __m256 l0 = _mm256_add_ps(g00, _mm256_mul_ps(u, _mm256_sub_ps(g10, g00)));
+    __m256 l1 = _mm256_add_ps(g01, _mm256_mul_ps(u, _mm256_sub_ps(g11, g01)));
+    return _mm256_add_ps(l0, _mm256_mul_ps(v, _mm256_sub_ps(l1, l0)));
+}
+
+template<bool Ridged>
+DUNE_TARGET_AVX2 static void worldRowAVX2(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                                          int oct, float lac, float gain)
+{
+    const WorldOrigin& w = *(const WorldOrigin*)ctx;
+    const uint32_t seed = *(const uint32_t*)w.base;
+    CellCache cache[kMaxOctaves];
+    for(int o=0;o<oct;o++) fillCellHashed(seed, w.o[o].cx, w.o[o].cy, cache[o]);
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+    for(int i=0;i<n;i+=8){
+        const int cnt = std::min(8, n-i);
+        __m256 x, y;
+        if(cnt == 8){
+            x = _mm256_loadu_ps(xs+i); y = _mm256_loadu_ps(ys+i);
+        }else{
+            alignas(32) float bx[8], by[8];
+            for(int k=0;k<8;k++){ int s = i + std::min(k, cnt-1); bx[k]=xs[s]; by[k]=ys[s]; }
+            x = _mm256_load_ps(bx); y = _mm256_load_ps(by);
+        }
+
+        __m256 sum = _mm256_setzero_ps();
+        float amp=0.5f, freq=1.f;
+        for(int o=0;o<oct;o++){
+            const LatticeOrigin& g = w.o[o];
+            __m256 f = _mm256_set1_ps(freq), a = _mm256_set1_ps(amp);
+            __m256 px = _mm256_add_ps(_mm256_set1_ps(g.fx), _mm256_mul_ps(x, f));
+            __m256 py = _mm256_add_ps(_mm256_set1_ps(g.fy), _mm256_mul_ps(y, f));
+            __m256 p = perlin8W(seed, g, px, py, cache[o]);
+            if(Ridged){
+                __m256 r = _mm256_sub_ps(one, _mm256_and_ps(p, absMask));
+                r = _mm256_mul_ps(r, r);
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(r, a));
+            }else{
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(a, p));
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged) sum = _mm256_min_ps(_mm256_max_ps(sum, _mm256_setzero_ps()), one);
+
+        if(cnt == 8){
+            _mm256_storeu_ps(out+i, sum);
+        }else{
+            alignas(32) float bo[8];
+            _mm256_store_ps(bo, sum);
+            for(int k=0;k<cnt;k++) out[i+k] = bo[k];
+        }
+    }
+}
+
+// --- apercu int16 (16 voies par registre, cf. perlinQ12) ---
+
+DUNE_TARGET_AVX2 static inline __m256i fadeQ16(__m256i q)
+{
+    __m256i f2 = _mm256_mulhrs_epi16(q, q), f3 = _mm256_mulhrs_epi16(f2, q);
+    __m256i t = _mm256_sub_epi16(f2, f3);
+    return _mm256_adds_epi16(f2, _mm256_adds_epi16(t, t));
+}
+
+DUNE_TARGET_AVX2 static inline void gradXYQ16(__m256i h, __m256i& gx, __m256i& gy)
+{
+    __m256i sw = _mm256_cmpeq_epi16(_mm256_and_si256(h, _mm256_set1_epi16(4)), _mm256_set1_epi16(4));
+    __m256i s1 = _mm256_sub_epi16(_mm256_set1_epi16(1), _mm256_slli_epi16(_mm256_and_si256(h, _mm256_set1_epi16(1)), 1));
+    __m256i s2 = _mm256_sub_epi16(_mm256_set1_epi16(2), _mm256_slli_epi16(_mm256_and_si256(h, _mm256_set1_epi16(2)), 1));
+    gx = _mm256_blendv_epi8(s1, s2, sw);
+    gy = _mm256_blendv_epi8(s2, s1, sw);
+}
+
+DUNE_TARGET_AVX2 static inline __m256i perlinQ16(const __m256i* gx, const __m256i* gy, __m256i qx, __m256i qy)
+{
+    const __m256i one = _mm256_set1_epi16(4096);
+    __m256i u = fadeQ16(qx), v = fadeQ16(qy);
+    __m256i x = _mm256_srai_epi16(qx, 3), y = _mm256_srai_epi16(qy, 3);
+    __m256i xm = _mm256_sub_epi16(x, one), ym = _mm256_sub_epi16(y, one);
+    __m256i g00 = _mm256_add_epi16(_mm256_mullo_epi16(x,  gx[0]), _mm256_mullo_epi16(y,  gy[0]));
+    __m256i g10 = _mm256_add_epi16(_mm256_mullo_epi16(xm, gx[1]), _mm256_mullo_epi16(y,  gy[1]));
+    __m256i g01 = _mm256_add_epi16(_mm256_mullo_epi16(x,  gx[2]), _mm256_mullo_epi16(ym, gy[2]));
+    __m256i g11 = _mm256_add_epi16(_mm256_mullo_epi16(xm, gx[3]), _mm256_mullo_epi16(ym, gy[3]));
+    __m256i l0 = _mm256_add_epi16(g00, _mm256_mulhrs_epi16(u, _mm256_sub_epi16(g10, g00)));
+    __m256i l1 = _mm256_add_epi16(g01, _mm256_mulhrs_epi16(u, _mm256_sub_epi16(g11, g01)));
+    return _mm256_add_epi16(l0, _mm256_mulhrs_epi16(v, _mm256_sub_epi16(l1, l0)));
+}
+
+// 8 voies float -> cellule (X | Y<<8) et fractions Q15 (int32)
+DUNE_TARGET_AVX2 static inline void latticeQ8(__m256 x, __m256 y, __m256i& cell, __m256i& qx, __m256i& qy)
+{
+    const __m256i m255 = _mm256_set1_epi32(255), qmax = _mm256_set1_epi32(32767);
+    const __m256 s = _mm256_set1_ps(32768.f);
+    __m256 fx = _mm256_floor_ps(x), fy = _mm256_floor_ps(y);
+    __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(fx), m255);
+    __m256i Y = _mm256_and_si256(_mm256_cvttps_epi32(fy), m255);
+    cell = _mm256_or_si256(X, _mm256_slli_epi32(Y, 8));
+    qx = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(x, fx), s)), qmax);
+    qy = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(y, fy), s)), qmax);
+}
+
+// Gradients des 16 voies : constantes de la PreviewCell si toutes les voies
+// tombent dans la meme cellule, sinon 2 gathers (16 bits utiles par lecture).
+DUNE_TARGET_AVX2 static inline void cellGradsQ16(const uint16_t* cells, __m256i c0, __m256i c1, PreviewCell& pc,
+                                                 __m256i* gx, __m256i* gy)
+{
+    const int cell0 = _mm256_cvtsi256_si32(c0);
+    const __m256i b = _mm256_set1_epi32(cell0);
+    const __m256i same = _mm256_and_si256(_mm256_cmpeq_epi32(c0, b), _mm256_cmpeq_epi32(c1, b));
+    if(_mm256_movemask_epi8(same) == -1){
+        if(cell0 != pc.cell) fillPreviewCell(cell0, cells[cell0], pc);
+        for(int k=0;k<4;k++){ gx[k] = _mm256_set1_epi16(pc.gx[k]); gy[k] = _mm256_set1_epi16(pc.gy[k]); }
+        return;
+    }
+    const __m256i m16 = _mm256_set1_epi32(0xFFFF);
+    __m256i g0 = _mm256_and_si256(_mm256_i32gather_epi32((const int*)cells, c0, 2), m16);
+    __m256i g1 = _mm256_and_si256(_mm256_i32gather_epi32((const int*)cells, c1, 2), m16);
+    __m256i code = _mm256_packs_epi32(g0, g1);
+    const __m256i m7 = _mm256_set1_epi16(7);
+    for(int k=0;k<4;k++) gradXYQ16(_mm256_and_si256(_mm256_srli_epi16(code, 3*k), m7), gx[k], gy[k]);
+}
+
+template<bool Ridged>
+DUNE_TARGET_AVX2 static void previewRowAVX2(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                                            int oct, float lac, float gain)
+{
+    const uint16_t* cells = (const uint16_t*)ctx;
+    PreviewCell cache[kCellCaches];
+    for(int i=0;i<n;i+=16){
+        const int cnt = std::min(16, n-i);
+        // blocs pleins : chargement direct (la copie scalaire dans un tampon
+        // bloque le store forwarding du chargement vectoriel)
+        __m256 x0, x1, y0, y1;
+        if(cnt == 16){
+            x0 = _mm256_loadu_ps(xs+i); x1 = _mm256_loadu_ps(xs+i+8);
+            y0 = _mm256_loadu_ps(ys+i); y1 = _mm256_loadu_ps(ys+i+8);
+        }else{
+            alignas(32) float bx[16], by[16];
+            for(int k=0;k<16;k++){ int s = i + std::min(k, cnt-1); bx[k]=xs[s]; by[k]=ys[s]; }
+            x0 = _mm256_load_ps(bx); x1 = _mm256_load_ps(bx+8);
+            y0 = _mm256_load_ps(by); y1 = _mm256_load_ps(by+8);
+        }
+
+        __m256i sum = _mm256_setzero_si256();
+        float amp=0.5f, freq=1.f;
+        for(int o=0;o<oct;o++){
+            __m256 f = _mm256_set1_ps(freq);
+            __m256i c0, c1, qx0, qx1, qy0, qy1, gx[4], gy[4];
+            latticeQ8(_mm256_mul_ps(x0, f), _mm256_mul_ps(y0, f), c0, qx0, qy0);
+            latticeQ8(_mm256_mul_ps(x1, f), _mm256_mul_ps(y1, f), c1, qx1, qy1);
+            cellGradsQ16(cells, c0, c1, cache[o & (kCellCaches-1)], gx, gy);
+            __m256i p = perlinQ16(gx, gy, _mm256_packs_epi32(qx0, qx1), _mm256_packs_epi32(qy0, qy1));
+            __m256i a = _mm256_set1_epi16((short)std::min(32767, (int)(amp*32768.f)));
+            if(Ridged){
+                __m256i r = _mm256_sub_epi16(_mm256_set1_epi16(4096), _mm256_abs_epi16(p));
+                __m256i r2 = _mm256_mulhrs_epi16(r, _mm256_slli_epi16(r, 2));
+                r2 = _mm256_add_epi16(r2, r2);
+                sum = _mm256_adds_epi16(sum, _mm256_mulhrs_epi16(r2, a));
+            }else{
+                sum = _mm256_adds_epi16(sum, _mm256_mulhrs_epi16(p, a));
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged) sum = _mm256_min_epi16(_mm256_max_epi16(sum, _mm256_setzero_si256()), _mm256_set1_epi16(4096));
+
+        // packs_epi32 entrelace par blocs de 128 bits : {0-3, 8-11, 4-7, 12-15}
+        sum = _mm256_permute4x64_epi64(sum, 0xD8);
+        const __m256 k = _mm256_set1_ps(1.f/4096.f);
+        __m256 o0 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(sum))), k);
+        __m256 o1 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(sum, 1))), k);
+        if(cnt == 16){
+            _mm256_storeu_ps(out+i, o0); _mm256_storeu_ps(out+i+8, o1);
+        }else{
+            alignas(32) float bo[16];
+            _mm256_store_ps(bo, o0); _mm256_store_ps(bo+8, o1);
+            for(int k2=0;k2<cnt;k2++) out[i+k2] = bo[k2];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512F : 16 voies
+
+DUNE_TARGET_AVX512 static inline __m512 fade16(__m512 t)
+{
+    __m512 a = _mm512_mul_ps(t, _mm512_set1_ps(6.f));
+    a = _mm512_sub_ps(a, _mm512_set1_ps(15.f));
+    a = _mm512_mul_ps(a, t);
+    a = _mm512_add_ps(a, _mm512_set1_ps(10.f));
+    __m512 t3 = _mm512_mul_ps(_mm512_mul_ps(t, t), t);
+    return _mm512_mul_ps(t3, a);
+}
+
+DUNE_TARGET_AVX512 static inline __m512 grad16(__m512i h, __m512 x, __m512 y)
+{
+    h = _mm512_and_si512(h, _mm512_set1_epi32(7));
+    __mmask16 ge4 = _mm512_test_epi32_mask(h, _mm512_set1_epi32(4));
+    __m512 u = _mm512_mask_blend_ps(ge4, x, y);
+    __m512 v = _mm512_mask_blend_ps(ge4, y, x);
+    __m512i su = _mm512_slli_epi32(_mm512_and_si512(h, _mm512_set1_epi32(1)), 31);
+    __m512i sv = _mm512_slli_epi32(_mm512_and_si512(h, _mm512_set1_epi32(2)), 30);
+    v = _mm512_mul_ps(_mm512_set1_ps(2.f), v);
+    __m512 a = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(u), su));
+    __m512 b = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(v), sv));
+    return _mm512_add_ps(a, b);
+}
+
+DUNE_TARGET_AVX512 static inline __m512 perlin16(const int* perm, __m512 x, __m512 y, __mmask16 lanes, CellCache& c)
+{
+    const __m512 one = _mm512_set1_ps(1.f);
+    const __m512i m255 = _mm512_set1_epi32(255);
+    const __m512i i1 = _mm512_set1_epi32(1);
+
+    __m512 fx = _mm512_mask_roundscale_ps(x, 0xFFFF, x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512 fy = _mm512_mask_roundscale_ps(y, 0xFFFF, y, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512i X = _mm512_and_si512(_mm512_cvttps_epi32(fx), m255);
+    __m512i Y = _mm512_and_si512(_mm512_cvttps_epi32(fy), m255);
+    x = _mm512_sub_ps(x, fx); y = _mm512_sub_ps(y, fy);
+    __m512 u = fade16(x), v = fade16(y);
+
+    __m512 xm = _mm512_sub_ps(x, one), ym = _mm512_sub_ps(y, one);
+    __m512 g00, g10, g01, g11;
+
+    const int X0 = _mm_cvtsi128_si32(_mm512_castsi512_si128(X)), Y0 = _mm_cvtsi128_si32(_mm512_castsi512_si128(Y));
+    __mmask16 same = _mm512_mask_cmpeq_epi32_mask(lanes, X, _mm512_set1_epi32(X0));
+    same = _mm512_mask_cmpeq_epi32_mask(same, Y, _mm512_set1_epi32(Y0));
+    if(same == lanes){
+        if(X0 != c.X || Y0 != c.Y) fillCell(perm, X0, Y0, c);
+        g00 = _mm512_add_ps(_mm512_mul_ps(x,  _mm512_set1_ps(c.gx[0])), _mm512_mul_ps(y,  _mm512_set1_ps(c.gy[0])));
+        g10 = _mm512_add_ps(_mm512_mul_ps(xm, _mm512_set1_ps(c.gx[1])), _mm512_mul_ps(y,  _mm512_set1_ps(c.gy[1])));
+        g01 = _mm512_add_ps(_mm512_mul_ps(x,  _mm512_set1_ps(c.gx[2])), _mm512_mul_ps(ym, _mm512_set1_ps(c.gy[2])));
+        g11 = _mm512_add_ps(_mm512_mul_ps(xm, _mm512_set1_ps(c.gx[3])), _mm512_mul_ps(ym, _mm512_set1_ps(c.gy[3])));
+    }else{
+        __m512i A = _mm512_add_epi32(_mm512_i32gather_epi32(X, perm, 4), Y);
+        __m512i B = _mm512_add_epi32(_mm512_i32gather_epi32(_mm512_add_epi32(X, i1), perm, 4), Y);
+        g00 = grad16(_mm512_i32gather_epi32(A, perm, 4), x, y);
+        g10 = grad16(_mm512_i32gather_epi32(B, perm, 4), xm, y);
+        g01 = grad16(_mm512_i32gather_epi32(_mm512_add_epi32(A, i1), perm, 4), x, ym);
+        g11 = grad16(_mm512_i32gather_epi32(_mm512_add_epi32(B, i1), perm, 4), xm, ym);
+    }
+
+    __m512 l0 = _mm512_add_ps(g00, _mm512_mul_ps(u, _mm512_sub_ps(g10, g00)));
+    __m512 l1 = _mm512_add_ps(g01, _mm512_mul_ps(u, _mm512_sub_ps(g11, g01)));
+    return _mm512_add_ps(l0, _mm512_mul_ps(v, _mm512_sub_ps(l1, l0)));
+}
+
+template<int Oct, bool Ridged>
+DUNE_TARGET_AVX512 static void fbmRowAVX512(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                                            int oct, float lac, float gain)
+{
+    const int* perm = (const int*)ctx;
+    const int nOct = Oct ? Oct : oct; // Oct > 0 : boucle deroulee a la compilation
+    CellCache cache[kCellCaches];
+    const __m512 one = _mm512_set1_ps(1.f);
+    const __m512i absMask = _mm512_set1_epi32(0x7fffffff);
+
+    for(int i=0;i<n;i+=16){
+        const int cnt = std::min(16, n-i);
+        const __mmask16 m = (__mmask16)((1u << cnt) - 1u);
+        // les voies hors ligne restent a 0 : pas de lecture hors tableau
+        __m512 x = _mm512_maskz_loadu_ps(m, xs+i);
+        __m512 y = _mm512_maskz_loadu_ps(m, ys+i);
+
+        __m512 sum = _mm512_setzero_ps();
+        float amp=0.5f, freq=1.f;
+        for(int o=0;o<nOct;o++){
+            __m512 f = _mm512_set1_ps(freq), a = _mm512_set1_ps(amp);
+            __m512 p = perlin16(perm, _mm512_mul_ps(x, f), _mm512_mul_ps(y, f), m, cache[o & (kCellCaches-1)]);
+            if(Ridged){
+                __m512 ap = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(p), absMask));
+                __m512 r = _mm512_sub_ps(one, ap);
+                r = _mm512_mul_ps(r, r);
+                sum = _mm512_add_ps(sum, _mm512_mul_ps(r, a));
+            }else{
+                sum = _mm512_add_ps(sum, _mm512_mul_ps(a, p));
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged) sum = _mm512_min_ps(_mm512_max_ps(sum, _mm512_setzero_ps()), one);
+
+        _mm512_mask_storeu_ps(out+i, m, sum);
+    }
+}
+
+// --- derivees analytiques (valeur identique a perlin16) ---
+
+DUNE_TARGET_AVX512 static inline __m512 dfade16(__m512 t)
+{
+    __m512 tm = _mm512_sub_ps(t, _mm512_set1_ps(1.f));
+    __m512 a = _mm512_mul_ps(_mm512_mul_ps(t, t), _mm512_mul_ps(tm, tm));
+    return _mm512_mul_ps(_mm512_set1_ps(30.f), a);
+}
+
+DUNE_TARGET_AVX512 static inline __m512 xorSign16(__m512 a, __m512i bits)
+{
+    return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), bits));
+}
+
+DUNE_TARGET_AVX512 static inline void gradXY16(__m512i h, __m512& gx, __m512& gy)
+{
+    h = _mm512_and_si512(h, _mm512_set1_epi32(7));
+    __mmask16 ge4 = _mm512_test_epi32_mask(h, _mm512_set1_epi32(4));
+    __m512 s1 = xorSign16(_mm512_set1_ps(1.f), _mm512_slli_epi32(_mm512_and_si512(h, _mm512_set1_epi32(1)), 31));
+    __m512 s2 = xorSign16(_mm512_set1_ps(2.f), _mm512_slli_epi32(_mm512_and_si512(h, _mm512_set1_epi32(2)), 30));
+    gx = _mm512_mask_blend_ps(ge4, s1, s2);
+    gy = _mm512_mask_blend_ps(ge4, s2, s1);
+}
+
+DUNE_TARGET_AVX512 static inline __m512 perlin16D(const int* perm, __m512 x, __m512 y, __mmask16 lanes, CellCache& c,
+                                                  __m512& dx, __m512& dy)
+{
+    const __m512 one = _mm512_set1_ps(1.f);
+    const __m512i m255 = _mm512_set1_epi32(255);
+    const __m512i i1 = _mm512_set1_epi32(1);
+
+    __m512 fx = _mm512_mask_roundscale_ps(x, 0xFFFF, x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512 fy = _mm512_mask_roundscale_ps(y, 0xFFFF, y, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512i X = _mm512_and_si512(_mm512_cvttps_epi32(fx), m255);
+    __m512i Y = _mm512_and_si512(_mm512_cvttps_epi32(fy), m255);
+    x = _mm512_sub_ps(x, fx); y = _mm512_sub_ps(y, fy);
+    __m512 u = fade16(x), v = fade16(y);
+    __m512 du = dfade16(x), dv = dfade16(y);
+
+    __m512 xm = _mm512_sub_ps(x, one), ym = _mm512_sub_ps(y, one);
+    __m512 gx[4], gy[4];
+
+    const int X0 = _mm_cvtsi128_si32(_mm512_castsi512_si128(X)), Y0 = _mm_cvtsi128_si32(_mm512_castsi512_si128(Y));
+    __mmask16 same = _mm512_mask_cmpeq_epi32_mask(lanes, X, _mm512_set1_epi32(X0));
+    same = _mm512_mask_cmpeq_epi32_mask(same, Y, _mm512_set1_epi32(Y0));
+    if(same == lanes){
+        if(X0 != c.X || Y0 != c.Y) fillCell(perm, X0, Y0, c);
+        for(int k=0;k<4;k++){ gx[k] = _mm512_set1_ps(c.gx[k]); gy[k] = _mm512_set1_ps(c.gy[k]); }
+    }else{
+        __m512i A = _mm512_add_epi32(_mm512_i32gather_epi32(X, perm, 4), Y);
+        __m512i B = _mm512_add_epi32(_mm512_i32gather_epi32(_mm512_add_epi32(X, i1), perm, 4), Y);
+        gradXY16(_mm512_i32gather_epi32(A, perm, 4), gx[0], gy[0]);
+        gradXY16(_mm512_i32gather_epi32(B, perm, 4), gx[1], gy[1]);
+        gradXY16(_mm512_i32gather_epi32(_mm512_add_epi32(A, i1), perm, 4), gx[2], gy[2]);
+        gradXY16(_mm512_i32gather_epi32(_mm512_add_epi32(B, i1), perm, 4), gx[3], gy[3]);
+    }
+
+    __m512 g00 = _mm512_add_ps(_mm512_mul_ps(x,  gx[0]), _mm512_mul_ps(y,  gy[0]));
+    __m512 g10 = _mm512_add_ps(_mm512_mul_ps(xm, gx[1]), _mm512_mul_ps(y,  gy[1]));
+    __m512 g01 = _mm512_add_ps(_mm512_mul_ps(x,  gx[2]), _mm512_mul_ps(ym, gy[2]));
+    __m512 g11 = _mm512_add_ps(_mm512_mul_ps(xm, gx[3]), _mm512_mul_ps(ym, gy[3]));
+
+    __m512 l0 = _mm512_add_ps(g00, _mm512_mul_ps(u, _mm512_sub_ps(g10, g00)));
+    __m512 l1 = _mm512_add_ps(g01, _mm512_mul_ps(u, _mm512_sub_ps(g11, g01)));
+
+    __m512 k1 = _mm512_sub_ps(g10, g00);
+    __m512 k2 = _mm512_sub_ps(g01, g00);
+    __m512 k3 = _mm512_add_ps(_mm512_sub_ps(_mm512_sub_ps(g00, g10), g01), g11);
+    __m512 uv = _mm512_mul_ps(u, v);
+
+    __m512 ex = _mm512_add_ps(_mm512_sub_ps(_mm512_sub_ps(gx[0], gx[1]), gx[2]), gx[3]);
+    dx = _mm512_add_ps(gx[0], _mm512_mul_ps(u, _mm512_sub_ps(gx[1], gx[0])));
+    dx = _mm512_add_ps(dx, _mm512_mul_ps(v, _mm512_sub_ps(gx[2], gx[0])));
+    dx = _mm512_add_ps(dx, _mm512_mul_ps(uv, ex));
+    dx = _mm512_add_ps(dx, _mm512_mul_ps(du, _mm512_add_ps(k1, _mm512_mul_ps(v, k3))));
+
+    __m512 ey = _mm512_add_ps(_mm512_sub_ps(_mm512_sub_ps(gy[0], gy[1]), gy[2]), gy[3]);
+    dy = _mm512_add_ps(gy[0], _mm512_mul_ps(u, _mm512_sub_ps(gy[1], gy[0])));
+    dy = _mm512_add_ps(dy, _mm512_mul_ps(v, _mm512_sub_ps(gy[2], gy[0])));
+    dy = _mm512_add_ps(dy, _mm512_mul_ps(uv, ey));
+    dy = _mm512_add_ps(dy, _mm512_mul_ps(dv, _mm512_add_ps(k2, _mm512_mul_ps(u, k3))));
+
+    return _mm512_add_ps(l0, _mm512_mul_ps(v, _mm512_sub_ps(l1, l0)));
+}
+
+template<bool Ridged>
+DUNE_TARGET_AVX512 static void fbmRowDAVX512(const void* ctx, const float* xs, const float* ys, float* out,
+                                              float* dxo, float* dyo, int n, int oct, float lac, float gain)
+{
+    const int* perm = (const int*)ctx;
+    CellCache cache[kCellCaches];
+    const __m512 one = _mm512_set1_ps(1.f);
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512i absMask = _mm512_set1_epi32(0x7fffffff);
+    const __m512i signMask = _mm512_set1_epi32((int)0x80000000);
+
+    for(int i=0;i<n;i+=16){
+        const int cnt = std::min(16, n-i);
+        const __mmask16 m = (__mmask16)((1u << cnt) - 1u);
+        __m512 x = _mm512_maskz_loadu_ps(m, xs+i);
+        __m512 y = _mm512_maskz_loadu_ps(m, ys+i);
+
+        __m512 sum = zero, sx = zero, sy = zero;
+        float amp=0.5f, freq=1.f;
+        for(int o=0;o<oct;o++){
+            __m512 f = _mm512_set1_ps(freq), a = _mm512_set1_ps(amp);
+            __m512 dpx, dpy;
+            __m512 p = perlin16D(perm, _mm512_mul_ps(x, f), _mm512_mul_ps(y, f), m, cache[o & (kCellCaches-1)], dpx, dpy);
+            if(Ridged){
+                __m512 ap = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(p), absMask));
+                __m512 q = _mm512_sub_ps(one, ap);
+                sum = _mm512_add_ps(sum, _mm512_mul_ps(_mm512_mul_ps(q, q), a));
+                __m512 k = _mm512_mul_ps(q, _mm512_set1_ps(-2.f*amp*freq));
+                k = xorSign16(k, _mm512_and_si512(_mm512_castps_si512(p), signMask));
+                sx = _mm512_add_ps(sx, _mm512_mul_ps(k, dpx));
+                sy = _mm512_add_ps(sy, _mm512_mul_ps(k, dpy));
+            }else{
+                sum = _mm512_add_ps(sum, _mm512_mul_ps(a, p));
+                __m512 k = _mm512_set1_ps(amp*freq);
+                sx = _mm512_add_ps(sx, _mm512_mul_ps(k, dpx));
+                sy = _mm512_add_ps(sy, _mm512_mul_ps(k, dpy));
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged){
+            __mmask16 in = _mm512_cmp_ps_mask(sum, zero, _CMP_GE_OQ) & _mm512_cmp_ps_mask(sum, one, _CMP_LE_OQ);
+            sx = _mm512_maskz_mov_ps(in, sx); sy = _mm512_maskz_mov_ps(in, sy);
+            sum = _mm512_min_ps(_mm512_max_ps(sum, zero), one);
+        }
+
+        _mm512_mask_storeu_ps(out+i, m, sum);
+        _mm512_mask_storeu_ps(dxo+i, m, sx);
+        _mm512_mask_storeu_ps(dyo+i, m, sy);
+    }
+}
+
+// --- monde etendu : gradients hashes (cf. perlin8W) ---
+
+DUNE_TARGET_AVX512 static inline __m512i hashCode16(__m512i seed, __m512i xh, __m512i yh)
+{
+    __m512i h = _mm512_xor_si512(seed, _mm512_xor_si512(xh, yh));
+    h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 15)); h = _mm512_mullo_epi32(h, _mm512_set1_epi32(0x2c1b3c6d));
+    h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 12)); h = _mm512_mullo_epi32(h, _mm512_set1_epi32(0x297a2d39));
+    h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 15));
+    return _mm512_srli_epi32(h, 29);
+}
+
+DUNE_TARGET_AVX512 static inline __m512 perlin16W(uint32_t seed, const LatticeOrigin& g, __m512 x, __m512 y,
+                                                  __mmask16 lanes, CellCache& c)
+{
+    const __m512 one = _mm512_set1_ps(1.f);
+
+    __m512 fx = _mm512_mask_roundscale_ps(x, 0xFFFF, x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512 fy = _mm512_mask_roundscale_ps(y, 0xFFFF, y, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512i X = _mm512_add_epi32(_mm512_set1_epi32(g.cx), _mm512_cvttps_epi32(fx));
+    __m512i Y = _mm512_add_epi32(_mm512_set1_epi32(g.cy), _mm512_cvttps_epi32(fy));
+    x = _mm512_sub_ps(x, fx); y = _mm512_sub_ps(y, fy);
+    __m512 u = fade16(x), v = fade16(y);
+
+    __m512 xm = _mm512_sub_ps(x, one), ym = _mm512_sub_ps(y, one);
+    __m512 g00, g10, g01, g11;
+
+    const int X0 = _mm_cvtsi128_si32(_mm512_castsi512_si128(X)), Y0 = _mm_cvtsi128_si32(_mm512_castsi512_si128(Y));
+    __mmask16 same = _mm512_mask_cmpeq_epi32_mask(lanes, X, _mm512_set1_epi32(X0));
+    same = _mm512_mask_cmpeq_epi32_mask(same, Y, _mm512_set1_epi32(Y0));
+    if(same == lanes){
+        if(X0 != c.X || Y0 != c.Y) fillCellHashed(seed, X0, Y0, c);
+        g00 = _mm512_add_ps(_mm512_mul_ps(x,  _mm512_set1_ps(c.gx[0])), _mm512_mul_ps(y,  _mm512_set1_ps(c.gy[0])));
+        g10 = _mm512_add_ps(_mm512_mul_ps(xm, _mm512_set1_ps(c.gx[1])), _mm512_mul_ps(y,  _mm512_set1_ps(c.gy[1])));
+        g01 = _mm512_add_ps(_mm512_mul_ps(x,  _mm512_set1_ps(c.gx[2])), _mm512_mul_ps(ym, _mm512_set1_ps(c.gy[2])));
+        g11 = _mm512_add_ps(_mm512_mul_ps(xm, _mm512_set1_ps(c.gx[3])), _mm512_mul_ps(ym, _mm512_set1_ps(c.gy[3])));
+    }else{
+        const __m512i kx = _mm512_set1_epi32(0x27d4eb2d), ky = _mm512_set1_epi32(0x165667b1);
+        const __m512i sd = _mm512_set1_epi32((int)seed);
+        __m512i x0 = _mm512_mullo_epi32(X, kx), x1 = _mm512_add_epi32(x0, kx);
+        __m512i y0 = _mm512_mullo_epi32(Y, ky), y1 = _mm512_add_epi32(y0, ky);
+        g00 = grad16(hashCode16(sd, x0, y0), x, y);
+        g10 = grad16(hashCode16(sd, x1, y0), xm, y);
+        g01 = grad16(hashCode16(sd, x0, y1), x, ym);
+        g11 = grad16(hashCode16(sd, x1, y1), xm, ym);
+    }
+
+    __m512 l0 = _mm512_add_ps(g00, _mm512_mul_ps(u, _mm512_sub_ps(g10, g00)));
+    __m512 l1 = _mm512_add_ps(g01, _mm512_mul_ps(u, _mm512_sub_ps(g11, g01)));
+    return _mm512_add_ps(l0, _mm512_mul_ps(v, _mm512_sub_ps(l1, l0)));
+}
+
+template<bool Ridged>
+DUNE_TARGET_AVX512 static void worldRowAVX512(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                                              int oct, float lac, float gain)
+{
+    const WorldOrigin& w = *(const WorldOrigin*)ctx;
+    const uint32_t seed = *(const uint32_t*)w.base;
+    CellCache cache[kMaxOctaves];
+    for(int o=0;o<oct;o++) fillCellHashed(seed, w.o[o].cx, w.o[o].cy, cache[o]);
+    const __m512 one = _mm512_set1_ps(1.f);
+    const __m512i absMask = _mm512_set1_epi32(0x7fffffff);
+
+    for(int i=0;i<n;i+=16){
+        const int cnt = std::min(16, n-i);
+        const __mmask16 m = (__mmask16)((1u << cnt) - 1u);
+        __m512 x = _mm512_maskz_loadu_ps(m, xs+i);
+        __m512 y = _mm512_maskz_loadu_ps(m, ys+i);
+
+        __m512 sum = _mm512_setzero_ps();
+        float amp=0.5f, freq=1.f;
+        for(int o=0;o<oct;o++){
+            const LatticeOrigin& g = w.o[o];
+            __m512 f = _mm512_set1_ps(freq), a = _mm512_set1_ps(amp);
+            __m512 px = _mm512_add_ps(_mm512_set1_ps(g.fx), _mm512_mul_ps(x, f));
+            __m512 py = _mm512_add_ps(_mm512_set1_ps(g.fy), _mm512_mul_ps(y, f));
+            __m512 p = perlin16W(seed, g, px, py, m, cache[o]);
+            if(Ridged){
+                __m512 ap = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(p), absMask));
+                __m512 r = _mm512_sub_ps(one, ap);
+                r = _mm512_mul_ps(r, r);
+                sum = _mm512_add_ps(sum, _mm512_mul_ps(r, a));
+            }else{
+                sum = _mm512_add_ps(sum, _mm512_mul_ps(a, p));
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged) sum = _mm512_min_ps(_mm512_max_ps(sum, _mm512_setzero_ps()), one);
+
+        _mm512_mask_storeu_ps(out+i, m, sum);
+    }
+}
+
+// --- apercu int16 (32 voies, AVX-512BW ; cf. perlinQ12) ---
+
+// AVX-512BW (operations 16 bits sur zmm) : present sur tous les AVX-512
+// "serveur/client", absent des Xeon Phi. Detecte a part de SimdLevel.
+static bool hasAvx512bw()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    if(detectLevel() != SimdLevel::AVX512) return false;
+    int r[4];
+    __cpuidex(r, 7, 0);
+    return (r[1] & (1<<30)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+}
+
+DUNE_TARGET_AVX512BW static inline __m512i fadeQ32(__m512i q)
+{
+    __m512i f2 = _mm512_mulhrs_epi16(q, q), f3 = _mm512_mulhrs_epi16(f2, q);
+    __m512i t = _mm512_sub_epi16(f2, f3);
+    return _mm512_adds_epi16(f2, _mm512_adds_epi16(t, t));
+}
+
+DUNE_TARGET_AVX512BW static inline void gradXYQ32(__m512i h, __m512i& gx, __m512i& gy)
+{
+    __mmask32 sw = _mm512_test_epi16_mask(h, _mm512_set1_epi16(4));
+    __m512i s1 = _mm512_sub_epi16(_mm512_set1_epi16(1), _mm512_slli_epi16(_mm512_and_si512(h, _mm512_set1_epi16(1)), 1));
+    __m512i s2 = _mm512_sub_epi16(_mm512_set1_epi16(2), _mm512_slli_epi16(_mm512_and_si512(h, _mm512_set1_epi16(2)), 1));
+    gx = _mm512_mask_blend_epi16(sw, s1, s2);
+    gy = _mm512_mask_blend_epi16(sw, s2, s1);
+}
+
+DUNE_TARGET_AVX512BW static inline __m512i perlinQ32(const __m512i* gx, const __m512i* gy, __m512i qx, __m512i qy)
+{
+    const __m512i one = _mm512_set1_epi16(4096);
+    __m512i u = fadeQ32(qx), v = fadeQ32(qy);
+    __m512i x = _mm512_srai_epi16(qx, 3), y = _mm512_srai_epi16(qy, 3);
+    __m512i xm = _mm512_sub_epi16(x, one), ym = _mm512_sub_epi16(y, one);
+    __m512i g00 = _mm512_add_epi16(_mm512_mullo_epi16(x,  gx[0]), _mm512_mullo_epi16(y,  gy[0]));
+    __m512i g10 = _mm512_add_epi16(_mm512_mullo_epi16(xm, gx[1]), _mm512_mullo_epi16(y,  gy[1]));
+    __m512i g01 = _mm512_add_epi16(_mm512_mullo_epi16(x,  gx[2]), _mm512_mullo_epi16(ym, gy[2]));
+    __m512i g11 = _mm512_add_epi16(_mm512_mullo_epi16(xm, gx[3]), _mm512_mullo_epi16(ym, gy[3]));
+    __m512i l0 = _mm512_add_epi16(g00, _mm512_mulhrs_epi16(u, _mm512_sub_epi16(g10, g00)));
+    __m512i l1 = _mm512_add_epi16(g01, _mm512_mulhrs_epi16(u, _mm512_sub_epi16(g11, g01)));
+    return _mm512_add_epi16(l0, _mm512_mulhrs_epi16(v, _mm512_sub_epi16(l1, l0)));
+}
+
+DUNE_TARGET_AVX512BW static inline void latticeQ16(__m512 x, __m512 y, __m512i& cell, __m512i& qx, __m512i& qy)
+{
+    const __m512i m255 = _mm512_set1_epi32(255), qmax = _mm512_set1_epi32(32767);
+    const __m512 s = _mm512_set1_ps(32768.f);
+    __m512 fx = _mm512_mask_roundscale_ps(x, 0xFFFF, x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512 fy = _mm512_mask_roundscale_ps(y, 0xFFFF, y, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512i X = _mm512_and_si512(_mm512_cvttps_epi32(fx), m255);
+    __m512i Y = _mm512_and_si512(_mm512_cvttps_epi32(fy), m255);
+    cell = _mm512_or_si512(X, _mm512_slli_epi32(Y, 8));
+    qx = _mm512_min_epi32(_mm512_cvttps_epi32(_mm512_mul_ps(_mm512_sub_ps(x, fx), s)), qmax);
+    qy = _mm512_min_epi32(_mm512_cvttps_epi32(_mm512_mul_ps(_mm512_sub_ps(y, fy), s)), qmax);
+}
+
+DUNE_TARGET_AVX512BW static inline void cellGradsQ32(const uint16_t* cells, __m512i c0, __m512i c1, PreviewCell& pc,
+                                                     __m512i* gx, __m512i* gy)
+{
+    const int cell0 = _mm_cvtsi128_si32(_mm512_castsi512_si128(c0));
+    const __m512i b = _mm512_set1_epi32(cell0);
+    const __mmask16 same = _mm512_cmpeq_epi32_mask(c0, b) & _mm512_cmpeq_epi32_mask(c1, b);
+    if(same == 0xFFFF){
+        if(cell0 != pc.cell) fillPreviewCell(cell0, cells[cell0], pc);
+        for(int k=0;k<4;k++){ gx[k] = _mm512_set1_epi16(pc.gx[k]); gy[k] = _mm512_set1_epi16(pc.gy[k]); }
+        return;
+    }
+    const __m512i m16 = _mm512_set1_epi32(0xFFFF);
+    __m512i g0 = _mm512_and_si512(_mm512_i32gather_epi32(c0, (const int*)cells, 2), m16);
+    __m512i g1 = _mm512_and_si512(_mm512_i32gather_epi32(c1, (const int*)cells, 2), m16);
+    __m512i code = _mm512_packs_epi32(g0, g1);
+    const __m512i m7 = _mm512_set1_epi16(7);
+    for(int k=0;k<4;k++) gradXYQ32(_mm512_and_si512(_mm512_srli_epi16(code, 3*k), m7), gx[k], gy[k]);
+}
+
+template<bool Ridged>
+DUNE_TARGET_AVX512BW static void previewRowAVX512(const void* ctx, const float* xs, const float* ys, float* out, int n,
+                                                  int oct, float lac, float gain)
+{
+    const uint16_t* cells = (const uint16_t*)ctx;
+    PreviewCell cache[kCellCaches];
+    // packs_epi32 entrelace par blocs de 128 bits : remise en ordre a la fin
+    const __m512i order = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+    for(int i=0;i<n;i+=32){
+        const int cnt = std::min(32, n-i);
+        const int c0n = std::min(16, cnt), c1n = std::max(0, cnt-16);
+        const __mmask16 m0 = (__mmask16)((1u << c0n) - 1u), m1 = (__mmask16)((1u << c1n) - 1u);
+        __m512 x0 = _mm512_maskz_loadu_ps(m0, xs+i), x1 = _mm512_maskz_loadu_ps(m1, xs+i+16);
+        __m512 y0 = _mm512_maskz_loadu_ps(m0, ys+i), y1 = _mm512_maskz_loadu_ps(m1, ys+i+16);
+        if(c1n < 16){
+            // voies hors plage : copie de la premiere (meme cellule, pas de gather)
+            x1 = _mm512_mask_blend_ps(m1, _mm512_set1_ps(xs[i]), x1);
+            y1 = _mm512_mask_blend_ps(m1, _mm512_set1_ps(ys[i]), y1);
+            x0 = _mm512_mask_blend_ps(m0, _mm512_set1_ps(xs[i]), x0);
+            y0 = _mm512_mask_blend_ps(m0, _mm512_set1_ps(ys[i]), y0);
+        }
+
+        __m512i sum = _mm512_setzero_si512();
+        float amp=0.5f, freq=1.f;
+        for(int o=0;o<oct;o++){
+            __m512 f = _mm512_set1_ps(freq);
+            __m512i c0, c1, qx0, qx1, qy0, qy1, gx[4], gy[4];
+            latticeQ16(_mm512_mul_ps(x0, f), _mm512_mul_ps(y0, f), c0, qx0, qy0);
+            latticeQ16(_mm512_mul_ps(x1, f), _mm512_mul_ps(y1, f), c1, qx1, qy1);
+            cellGradsQ32(cells, c0, c1, cache[o & (kCellCaches-1)], gx, gy);
+            __m512i p = perlinQ32(gx, gy, _mm512_packs_epi32(qx0, qx1), _mm512_packs_epi32(qy0, qy1));
+            __m512i a = _mm512_set1_epi16((short)std::min(32767, (int)(amp*32768.f)));
+            if(Ridged){
+                __m512i r = _mm512_sub_epi16(_mm512_set1_epi16(4096), _mm512_abs_epi16(p));
+                __m512i r2 = _mm512_mulhrs_epi16(r, _mm512_slli_epi16(r, 2));
+                r2 = _mm512_add_epi16(r2, r2);
+                sum = _mm512_adds_epi16(sum, _mm512_mulhrs_epi16(r2, a));
+            }else{
+                sum = _mm512_adds_epi16(sum, _mm512_mulhrs_epi16(p, a));
+            }
+            freq*=lac; amp*=gain;
+        }
+        if(Ridged) sum = _mm512_min_epi16(_mm512_max_epi16(sum, _mm512_setzero_si512()), _mm512_set1_epi16(4096));
+
+        sum = _mm512_permutexvar_epi64(order, sum);
+        const __m512 k = _mm512_set1_ps(1.f/4096.f);
+        __m512 o0 = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm512_castsi512_si256(sum))), k);
+        __m512 o1 = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(sum, 1))), k);
+        _mm512_mask_storeu_ps(out+i, m0, o0);
+        _mm512_mask_storeu_ps(out+i+16, m1, o1);
+    }
+}
+
+// Table [ridged][oct] : oct 1..10 specialises, 0 = nombre d'octaves runtime
+#define DUNE_ROW_TABLE(K) { \
+    { K<0,false>, K<1,false>, K<2,false>, K<3,false>, K<4,false>, K<5,false>, \
+      K<6,false>, K<7,false>, K<8,false>, K<9,false>, K<10,false> }, \
+    { K<0,true>,  K<1,true>,  K<2,true>,  K<3,true>,  K<4,true>,  K<5,true>,  \
+      K<6,true>,  K<7,true>,  K<8,true>,  K<9,true>,  K<10,true> } }
+
+FbmRowFn fbmRowKernel(SimdLevel lvl, bool ridged, int oct)
+{
+    static const FbmRowFn sse41[2][kMaxSpecializedOctaves+1]  = DUNE_ROW_TABLE(fbmRowSSE41);
+    static const FbmRowFn avx2[2][kMaxSpecializedOctaves+1]   = DUNE_ROW_TABLE(fbmRowAVX2);
+    static const FbmRowFn avx512[2][kMaxSpecializedOctaves+1] = DUNE_ROW_TABLE(fbmRowAVX512);
+
+    const int o = (oct >= 1 && oct <= kMaxSpecializedOctaves) ? oct : 0;
+    switch(lvl){
+        case SimdLevel::AVX512: return avx512[ridged][o];
+        case SimdLevel::AVX2:   return avx2[ridged][o];
+        case SimdLevel::SSE41:  return sse41[ridged][o];
+        default: return nullptr;
+    }
+}
+
+FbmRowFn previewRowKernel(SimdLevel lvl, bool ridged)
+{
+    static const bool bw = hasAvx512bw();
+    if(lvl == SimdLevel::AVX512 && bw)
+        return ridged ? &previewRowAVX512<true> : &previewRowAVX512<false>;
+    switch(lvl){
+        case SimdLevel::AVX512:
+        case SimdLevel::AVX2:  return ridged ? &previewRowAVX2<true>  : &previewRowAVX2<false>;
+        case SimdLevel::SSE41: return ridged ? &previewRowSSE41<true> : &previewRowSSE41<false>;
+        default: return nullptr;
+    }
+}
+
+FbmRowDFn fbmRowDKernel(SimdLevel lvl, bool ridged)
+{
+    switch(lvl){
+        case SimdLevel::AVX512: return ridged ? &fbmRowDAVX512<true> : &fbmRowDAVX512<false>;
+        case SimdLevel::AVX2:   return ridged ? &fbmRowDAVX2<true>   : &fbmRowDAVX2<false>;
+        default: return nullptr; // SSE4.1 : chemin scalaire
+    }
+}
+
+FbmRowFn worldRowKernel(SimdLevel lvl, bool ridged)
+{
+    switch(lvl){
+        case SimdLevel::AVX512: return ridged ? &worldRowAVX512<true> : &worldRowAVX512<false>;
+        case SimdLevel::AVX2:   return ridged ? &worldRowAVX2<true>   : &worldRowAVX2<false>;
+        default: return nullptr; // SSE4.1 : chemin scalaire
+    }
+}
+
+#else // !DUNE_SIMD_X86
+
+SimdLevel detectLevel(){ return SimdLevel::Scalar; }
+FbmRowFn fbmRowKernel(SimdLevel, bool, int){ return nullptr; }
+FbmRowFn previewRowKernel(SimdLevel, bool){ return nullptr; }
+FbmRowDFn fbmRowDKernel(SimdLevel, bool){ return nullptr; }
+FbmRowFn worldRowKernel(SimdLevel, bool){ return nullptr; }
+
+#endif
+
+} // namespace simd
+} // namespace dune
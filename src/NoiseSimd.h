@@ -0,0 +1,154 @@
+// src/NoiseSimd.h
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "Noise.h"
+
+// Noyaux SIMD internes de Noise (voir NoiseSimd.cpp). Ne pas inclure ailleurs.
+
+namespace dune {
+namespace simd {
+
+using FbmRowFn = NoiseBackend::RowKernel::Fn;
+using FbmRowDFn = NoiseBackend::RowKernel::FnD;
+
+// Coherence de ligne : le long d'une ligne, les echantillons voisins tombent
+// souvent dans la meme cellule du reseau (basses frequences). On garde par
+// octave les gradients des 4 coins de la derniere cellule, et on ne relit la
+// table de permutation qu'au franchissement d'une frontiere de cellule.
+// grad(h,x,y) == gx*x + gy*y exactement (gx,gy dans {+-1,+-2}).
+struct CellCache {
+    int X = -1, Y = -1;     // cellule (deja masquee &255 ; brute en monde etendu)
+    float gx[4], gy[4];     // coins 00, 10, 01, 11
+};
+constexpr int kCellCaches = 32; // un par octave (puissance de 2)
+
+inline void fillCell(const int* perm, int X, int Y, CellCache& c)
+{
+    const int A = perm[X]+Y, B = perm[X+1]+Y;
+    const int h[4] = { perm[A], perm[B], perm[A+1], perm[B+1] };
+    for(int k=0;k<4;k++){
+        const int hk = h[k] & 7;
+        const float s1 = (hk & 1) ? -1.f : 1.f;
+        const float s2 = (hk & 2) ? -2.f : 2.f;
+        c.gx[k] = hk < 4 ? s1 : s2;
+        c.gy[k] = hk < 4 ? s2 : s1;
+    }
+    c.X = X; c.Y = Y;
+}
+
+// Monde etendu (Noise::worldRowKernel) : code de gradient de chaque coin tire
+// d'un hash 32 bits de la cellule (3 bits hauts) au lieu de la table 256.
+// X,Y non masques.
+inline void fillCellHashed(uint32_t seed, int32_t X, int32_t Y, CellCache& c)
+{
+    const int32_t X1 = cellAdd(X, 1), Y1 = cellAdd(Y, 1);
+    const uint32_t h[4] = { latticeHash(seed, X, Y), latticeHash(seed, X1, Y),
+                            latticeHash(seed, X, Y1), latticeHash(seed, X1, Y1) };
+    for(int k=0;k<4;k++){
+        const int hk = (int)(h[k] >> 29);
+        const float s1 = (hk & 1) ? -1.f : 1.f;
+        const float s2 = (hk & 2) ? -2.f : 2.f;
+        c.gx[k] = hk < 4 ? s1 : s2;
+        c.gy[k] = hk < 4 ? s2 : s1;
+    }
+    c.X = X; c.Y = Y;
+}
+
+// Apercu rapide (Noise::previewRowKernel) : les 4 codes de gradient (h&7) de
+// chaque cellule (X,Y) sont regroupes dans un uint16 (coin k sur les bits
+// 3k..3k+2, ordre 00,10,01,11) -> une seule lecture au lieu de 2 niveaux de
+// permutation x 4 coins. Fractions en Q15, produits scalaires et lerps en Q12
+// int16, fade cubique 3t^2-2t^3 a la place de la quintique.
+constexpr int kPreviewCells = 256*256;
+
+inline void fillPreviewCells(const int* perm, uint16_t* cells)
+{
+    for(int Y=0;Y<256;Y++){
+        for(int X=0;X<256;X++){
+            const int A = perm[X]+Y, B = perm[X+1]+Y;
+            const int h[4] = { perm[A], perm[B], perm[A+1], perm[B+1] };
+            uint16_t c = 0;
+            for(int k=0;k<4;k++) c |= (uint16_t)((h[k] & 7) << (3*k));
+            cells[X | (Y<<8)] = c;
+        }
+    }
+    cells[kPreviewCells] = 0; // garde : lecture 32 bits du dernier element
+}
+
+// == _mm_mulhrs_epi16
+inline int mulhrsQ(int a, int b){ return (a*b + 0x4000) >> 15; }
+
+// grad() en Q12 : a,b = offsets du coin
+inline int gradQ12(int h, int a, int b)
+{
+    int s = (h & 4) ? b : a, t = (h & 4) ? a : b;
+    if(h & 1) s = -s;
+    t += t;
+    if(h & 2) t = -t;
+    return s + t;
+}
+
+inline int16_t satQ(int v){ return (int16_t)std::min(32767, std::max(-32768, v)); }
+
+// fade cubique Q15 : 3t^2 - 2t^3 = t^2 + 2(t^2 - t^3), sature en haut
+inline int fadeQ15(int q)
+{
+    const int f2 = mulhrsQ(q, q), f3 = mulhrsQ(f2, q);
+    return satQ(f2 + satQ(2*(f2 - f3)));
+}
+
+// Gradients (gx,gy) d'une cellule d'apercu, par octave (cf. CellCache) :
+// gradQ12(h,a,b) == gx*a + gy*b exactement.
+struct PreviewCell {
+    int cell = -1;
+    int16_t gx[4], gy[4];
+};
+
+inline void fillPreviewCell(int cell, int code, PreviewCell& c)
+{
+    for(int k=0;k<4;k++){
+        const int h = (code >> (3*k)) & 7;
+        const int s1 = (h & 1) ? -1 : 1, s2 = (h & 2) ? -2 : 2;
+        c.gx[k] = (int16_t)(h < 4 ? s1 : s2);
+        c.gy[k] = (int16_t)(h < 4 ? s2 : s1);
+    }
+    c.cell = cell;
+}
+
+// Perlin Q12 a partir du code de cellule et des fractions Q15
+inline int perlinQ12(int code, int qx, int qy)
+{
+    const int u = fadeQ15(qx), v = fadeQ15(qy);
+    const int x = qx >> 3, y = qy >> 3, xm = x - 4096, ym = y - 4096;
+    const int g00 = gradQ12(code & 7, x, y);
+    const int g10 = gradQ12((code >> 3) & 7, xm, y);
+    const int g01 = gradQ12((code >> 6) & 7, x, ym);
+    const int g11 = gradQ12((code >> 9) & 7, xm, ym);
+    const int l0 = g00 + mulhrsQ(u, g10 - g00);
+    const int l1 = g01 + mulhrsQ(u, g11 - g01);
+    return l0 + mulhrsQ(v, l1 - l0);
+}
+
+SimdLevel detectLevel();
+
+// Instanciation specialisee (mode, octaves 1..10) ; nullptr si le niveau
+// n'est pas compile pour cette architecture.
+FbmRowFn fbmRowKernel(SimdLevel lvl, bool ridged, int oct);
+
+// Apercu int16 (voir fillPreviewCells) : ctx = table de cellules. nullptr si
+// pas de noyau SIMD. Au niveau AVX-512 : 32 voies si AVX-512BW, sinon le
+// noyau AVX2.
+FbmRowFn previewRowKernel(SimdLevel lvl, bool ridged);
+
+// Variante avec gradient analytique (AVX2 / AVX-512 seulement, octaves runtime)
+FbmRowDFn fbmRowDKernel(SimdLevel lvl, bool ridged);
+
+// Monde etendu (ctx = WorldOrigin, base = seed) : hash vectoriel, pas de
+// gather. AVX2 / AVX-512 seulement, octaves runtime.
+FbmRowFn worldRowKernel(SimdLevel lvl, bool ridged);
+
+} // namespace simd
+} // namespace dune
@@ -0,0 +1,206 @@
+// src/OpenSimplex2Noise.cpp
+#include "OpenSimplex2Noise.h"
+
+#include <cmath>
+
+namespace dune {
+
+namespace {
+
+constexpr uint64_t PRIME_X = 0x5205402B9270C86FULL;
+constexpr uint64_t PRIME_Y = 0x598CD327003817B5ULL;
+constexpr uint64_t HASH_MULTIPLIER = 0x53A3F72DEEC546F5ULL;
+
+constexpr double SKEW_2D = 0.366025403784439;
+constexpr double UNSKEW_2D = -0.21132486540518713;
+constexpr float RSQUARED_2D = 0.5f;
+
+constexpr int N_GRADS_2D_EXPONENT = 7;
+constexpr int N_GRADS_2D = 1 << N_GRADS_2D_EXPONENT;
+constexpr double NORMALIZER_2D = 0.01001634121365712;
+
+struct Gradients2D {
+    float g[N_GRADS_2D * 2];
+    Gradients2D()
+    {
+        static const float base[] = {
+             0.38268343236509f,   0.923879532511287f,
+             0.923879532511287f,  0.38268343236509f,
+             0.923879532511287f, -0.38268343236509f,
+             0.38268343236509f,  -0.923879532511287f,
+            -0.38268343236509f,  -0.923879532511287f,
+            -0.923879532511287f, -0.38268343236509f,
+            -0.923879532511287f,  0.38268343236509f,
+            -0.38268343236509f,   0.923879532511287f,
+
+             0.130526192220052f,  0.99144486137381f,
+             0.608761429008721f,  0.793353340291235f,
+             0.793353340291235f,  0.608761429008721f,
+             0.99144486137381f,   0.130526192220051f,
+             0.99144486137381f,  -0.130526192220051f,
+             0.793353340291235f, -0.60876142900872f,
+             0.608761429008721f, -0.793353340291235f,
+             0.130526192220052f, -0.99144486137381f,
+            -0.130526192220052f, -0.99144486137381f,
+            -0.608761429008721f, -0.793353340291235f,
+            -0.793353340291235f, -0.608761429008721f,
+            -0.99144486137381f,  -0.130526192220052f,
+            -0.99144486137381f,   0.130526192220051f,
+            -0.793353340291235f,  0.608761429008721f,
+            -0.608761429008721f,  0.793353340291235f,
+            -0.130526192220052f,  0.99144486137381f,
+        };
+        const int nBase = (int)(sizeof(base) / sizeof(base[0]));
+        for(int i=0;i<N_GRADS_2D*2;i++) g[i] = (float)(base[i % nBase] / NORMALIZER_2D);
+    }
+};
+
+const Gradients2D& gradients()
+{
+    static const Gradients2D G;
+    return G;
+}
+
+inline const float* gradAt(const float* G, int64_t seed, uint64_t xsvp, uint64_t ysvp)
+{
+    uint64_t hash = (uint64_t)seed ^ xsvp ^ ysvp;
+    hash *= HASH_MULTIPLIER;
+    hash ^= (uint64_t)((int64_t)hash >> (64 - N_GRADS_2D_EXPONENT + 1));
+    int gi = (int)hash & ((N_GRADS_2D - 1) << 1);
+    return G + gi;
+}
+
+// Contribution d'un coin : a^4 * <g, d>. Avec D, accumule aussi le gradient
+// -8 a^3 <g,d> d + a^4 g (le deskew rend d(dx,dy)/d(x,y) = identite).
+template<bool D>
+inline float corner(const float* g, float a, float dx, float dy, float* d)
+{
+    const float gd = g[0] * dx + g[1] * dy;
+    const float a2 = a * a, a4 = a2 * a2;
+    if(D){
+        const float k = -8.f * a2 * a * gd;
+        d[0] += k * dx + a4 * g[0];
+        d[1] += k * dy + a4 * g[1];
+    }
+    return a4 * gd;
+}
+
+// (cx,cy) : cellule simplexe d'origine (monde etendu, cf. splitLattice)
+template<bool D>
+float eval2(int64_t seed, float x, float y, float* d, int32_t cx = 0, int32_t cy = 0)
+{
+    const float* G = gradients().g;
+
+    // Skew vers la grille simplexe (en double pour garder la precision)
+    const double s = SKEW_2D * ((double)x + (double)y);
+    const double xs = x + s, ys = y + s;
+
+    const double fxs = std::floor(xs), fys = std::floor(ys);
+    const int64_t xsb = (int64_t)fxs + cx, ysb = (int64_t)fys + cy;
+    const float xi = (float)(xs - fxs), yi = (float)(ys - fys);
+
+    const uint64_t xsbp = (uint64_t)xsb * PRIME_X;
+    const uint64_t ysbp = (uint64_t)ysb * PRIME_Y;
+
+    const float t = (xi + yi) * (float)UNSKEW_2D;
+    const float dx0 = xi + t, dy0 = yi + t;
+
+    float value = 0;
+    const float a0 = RSQUARED_2D - dx0 * dx0 - dy0 * dy0;
+    if(a0 > 0) value = corner<D>(gradAt(G, seed, xsbp, ysbp), a0, dx0, dy0, d);
+
+    const float a1 = (float)(2 * (1 + 2 * UNSKEW_2D) * (1 / UNSKEW_2D + 2)) * t
+                   + ((float)(-2 * (1 + 2 * UNSKEW_2D) * (1 + 2 * UNSKEW_2D)) + a0);
+    if(a1 > 0){
+        const float dx1 = dx0 - (float)(1 + 2 * UNSKEW_2D);
+        const float dy1 = dy0 - (float)(1 + 2 * UNSKEW_2D);
+        value += corner<D>(gradAt(G, seed, xsbp + PRIME_X, ysbp + PRIME_Y), a1, dx1, dy1, d);
+    }
+
+    // 3e coin : choisi selon le demi-losange
+    if(dy0 > dx0){
+        const float dx2 = dx0 - (float)UNSKEW_2D;
+        const float dy2 = dy0 - (float)(UNSKEW_2D + 1);
+        const float a2 = RSQUARED_2D - dx2 * dx2 - dy2 * dy2;
+        if(a2 > 0) value += corner<D>(gradAt(G, seed, xsbp, ysbp + PRIME_Y), a2, dx2, dy2, d);
+    }else{
+        const float dx2 = dx0 - (float)(UNSKEW_2D + 1);
+        const float dy2 = dy0 - (float)UNSKEW_2D;
+        const float a2 = RSQUARED_2D - dx2 * dx2 - dy2 * dy2;
+        if(a2 > 0) value += corner<D>(gradAt(G, seed, xsbp + PRIME_X, ysbp), a2, dx2, dy2, d);
+    }
+
+    return value;
+}
+
+} // namespace
+
+float OpenSimplex2Noise::noise2(int64_t seed, float x, float y)
+{
+    return eval2<false>(seed, x, y, nullptr);
+}
+
+float OpenSimplex2Noise::noise2D(int64_t seed, float x, float y, float& dx, float& dy)
+{
+    float d[2] = { 0.f, 0.f };
+    const float v = eval2<true>(seed, x, y, d);
+    dx = d[0]; dy = d[1];
+    return v;
+}
+
+float OpenSimplex2Noise::sampleWCtx_(const void* ctx, int32_t cx, int32_t cy, float x, float y)
+{
+    return eval2<false>(*(const int64_t*)ctx, x, y, nullptr, cx, cy);
+}
+
+float OpenSimplex2Noise::sampleDWCtx_(const void* ctx, int32_t cx, int32_t cy, float x, float y, float& dx, float& dy)
+{
+    float d[2] = { 0.f, 0.f };
+    const float v = eval2<true>(*(const int64_t*)ctx, x, y, d, cx, cy);
+    dx = d[0]; dy = d[1];
+    return v;
+}
+
+// Cellule entiere en coordonnees skew, reste ramene en coordonnees normales :
+// le reseau simplexe est invariant par translation d'un noeud (I,J).
+LatticeOrigin OpenSimplex2Noise::splitLattice(double x, double y) const
+{
+    const double s = SKEW_2D * (x + y);
+    const double I = std::floor(x + s), J = std::floor(y + s);
+    const double t = UNSKEW_2D * (I + J);
+    LatticeOrigin g;
+    g.cx = (int32_t)(uint32_t)(uint64_t)(int64_t)I;
+    g.cy = (int32_t)(uint32_t)(uint64_t)(int64_t)J;
+    g.fx = (float)(x - (I + t));
+    g.fy = (float)(y - (J + t));
+    return g;
+}
+
+NoiseBackend::RowKernel OpenSimplex2Noise::worldRowKernel(bool ridged, int oct, float lac, float gain,
+                                                          double originX, double originY, WorldOrigin& w) const
+{
+    return genericWorldKernel<&OpenSimplex2Noise::sampleWCtx_, &OpenSimplex2Noise::sampleDWCtx_>(
+        *this, &seed_, ridged, oct, lac, gain, originX, originY, w);
+}
+
+float OpenSimplex2Noise::sampleDCtx_(const void* ctx, float x, float y, float& dx, float& dy)
+{
+    return noise2D(((const OpenSimplex2Noise*)ctx)->seed_, x, y, dx, dy);
+}
+
+float OpenSimplex2Noise::sampleCtx_(const void* ctx, float x, float y)
+{
+    return noise2(((const OpenSimplex2Noise*)ctx)->seed_, x, y);
+}
+
+NoiseBackend::RowKernel OpenSimplex2Noise::rowKernel(bool ridged, int oct, float lac, float gain) const
+{
+    RowKernel k;
+    k.fn = genericRowKernel<&OpenSimplex2Noise::sampleCtx_>(ridged, oct);
+    k.fnD = genericRowKernelD<&OpenSimplex2Noise::sampleDCtx_>(ridged);
+    k.ctx = this;
+    k.oct = oct; k.lac = lac; k.gain = gain;
+    return k;
+}
+
+} // namespace dune
@@ -0,0 +1,35 @@
+// src/OpenSimplex2Noise.h
+#pragma once
+
+#include "NoiseBackend.h"
+
+namespace dune {
+
+// OpenSimplex2 2D (variante "fast" de K.J. Gustavson, domaine public / CC0) :
+// grille simplexe, 3 coins par echantillon au lieu de 4, moins d'artefacts
+// alignes sur les axes que Perlin. Hash 64 bits, pas de periode a 256.
+class OpenSimplex2Noise : public NoiseBackend {
+public:
+    NoiseEngine engine() const override { return NoiseEngine::OpenSimplex2; }
+    void init(uint32_t seed = 1337) override { seed_ = (int64_t)seed; }
+    uint32_t seed() const override { return (uint32_t)seed_; }
+
+    float sample(float x, float y) const override { return noise2(seed_, x, y); }
+    float sampleD(float x, float y, float& dx, float& dy) const override { return noise2D(seed_, x, y, dx, dy); }
+    RowKernel rowKernel(bool ridged, int oct, float lac, float gain) const override;
+    RowKernel worldRowKernel(bool ridged, int oct, float lac, float gain,
+                             double originX, double originY, WorldOrigin& w) const override;
+    LatticeOrigin splitLattice(double x, double y) const override;
+
+private:
+    int64_t seed_ = 1337;
+
+    static float noise2(int64_t seed, float x, float y);
+    static float noise2D(int64_t seed, float x, float y, float& dx, float& dy);
+    static float sampleCtx_(const void* ctx, float x, float y);
+    static float sampleDCtx_(const void* ctx, float x, float y, float& dx, float& dy);
+    static float sampleWCtx_(const void* ctx, int32_t cx, int32_t cy, float x, float y);
+    static float sampleDWCtx_(const void* ctx, int32_t cx, int32_t cy, float x, float y, float& dx, float& dy);
+};
+
+} // namespace dune
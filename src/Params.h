@@ -9,6 +9,7 @@ namespace dune
     struct Params
     {
         // Bruit principal
+        int noiseEngine = 0; // NoiseEngine : 0 Perlin, 1 OpenSimplex2, 2 Value
         int octaves = 1;
         float lacunarity = 1.9f;
         float gain = 0.45f;
@@ -24,7 +25,11 @@ namespace dune
         float stretchY = 1.0f;
         float rotationDeg = 0.f;
 
-        // Rugosité fine
+        // Rugosité fine. Mode ridged : le fbm principal prend ridgeOctaves /
+        // ridgeLacunarity / ridgeGain (octaves, lacunarity, gain ne servent
+        // plus), puis n in [0,1] -> ((n - bias)/(1 - bias))^pow, creux
+        // attenues par ridgeAttenuation (1 = aucune). Hors mode ridged, aucun
+        // de ces champs ne change les hauteurs.
         float ridgeBias = 0.25f;
         float ridgePow = 1.5f;
         float ridgeGain = 0.5f;
@@ -37,6 +42,13 @@ namespace dune
         float noiseOffsetY = 0.f;
         float noiseZoom = 1.0f;
 
+        // Monde etendu : origines de chunk en double, decoupees en cellule
+        // entiere + fraction par octave ; hash 32 bits (pas de repetition a
+        // 256 cellules). Le motif differe du mode normal.
+        bool largeWorld = false;
+        double worldOriginX = 0.0; // centre de la grille de chunks (monde)
+        double worldOriginY = 0.0;
+
         // Crop
         int cropLeft = 0, cropRight = 0, cropTop = 0, cropBottom = 0;
 
@@ -53,6 +65,30 @@ namespace dune
         int chunkRows = 1;
         float chunkGapVisual = 10.0f;
 
+        // Streaming : la grille cols x rows suit la camera (camWorld, monde) ;
+        // chunk (cx,cy) entier a worldOrigin + (cx*terrainWidth, cy*terrainLength).
+        // Etapes gardees par chunk (offset monde) en LRU sous chunkCacheMB.
+        bool chunkStreaming = false;
+        double camWorldX = 0.0;
+        double camWorldY = 0.0;
+        int chunkCacheMB = 1024;
+
+        // Raccord : bords des chunks identiques entre voisins (bordure de
+        // calcul + recentrage global) ; le motif differe du mode par defaut
+        bool seamless = false;
+
+        // Grille stockee en 16 bits (echelle + offset par chunk) : moitie de
+        // la memoire, erreur ~ amplitude du chunk / 131070
+        bool quantizedStorage = false;
+
+        // Pyramide min/max/moyenne par chunk (apercus, LOD, exports reduits),
+        // construite a la generation : niveaux 1..mipLevels, 0 = aucune.
+        // Niveau 1 : 3/4 de la taille d'un chunk en float, total ~ 1 chunk
+        int mipLevels = 0;
+
+        // Generation parallele (chunks + tuiles 64x64, pool a vol de travail) : 0 = tous les coeurs
+        int threadCount = 0;
+
         // Flags
         bool filled = false;
         bool invertZ = false;
@@ -71,11 +107,29 @@ namespace dune
         float crestSharpen = 0.0f;
         float crestWidth = 1.0f;
 
+        // Sable eolien (plaques de Werner, cf. Aeolian), apres les cretes :
+        // vent selon rotationDeg, iterations au pas 1 seulement (pas sur les
+        // paliers d'apercu)
+        bool aeolianEnabled = false;
+        int aeolianIterations = 100;
+        float aeolianSlab = 0.5f;          // hauteur d'une plaque (monde)
+        int aeolianHop = 3;                // saut sous le vent, en cellules
+        float aeolianDepositSand = 0.6f;   // probabilite de depot sur sable
+        float aeolianDepositBare = 0.4f;   // ... sur sol nu
+        float aeolianSandDepth = 5.0f;     // sable mobile initial par cellule
+        float aeolianReposeDeg = 33.0f;    // angle de repos
+        int aeolianSeed = 1;
+
         //Pour le rendu ue5
         float render_intensity = 0.03f;
         float render_maxHeightMeters = 30.0f;
         float render_unrealHalfRange = 1.0f;
 
+        // Octaves, lacunarite et gain du fbm principal selon le mode
+        int noiseOctaves() const { return ridgedMode ? ridgeOctaves : octaves; }
+        float noiseLacunarity() const { return ridgedMode ? ridgeLacunarity : lacunarity; }
+        float noiseGain() const { return ridgedMode ? ridgeGain : gain; }
+
         void clampSafety()
         {
             gridW = std::max(2, gridW);
@@ -87,9 +141,24 @@ namespace dune
             chunkCols = std::max(1, chunkCols);
             chunkRows = std::max(1, chunkRows);
             chunkGapVisual = std::max(0.0f, chunkGapVisual);
+            threadCount = std::clamp(threadCount, 0, 256);
+            chunkCacheMB = std::clamp(chunkCacheMB, 0, 1 << 20);
+            mipLevels = std::clamp(mipLevels, 0, 16);
 
+            noiseEngine = std::clamp(noiseEngine, 0, 2);
             octaves = std::clamp(octaves, 1, 32);
             ridgeOctaves = std::clamp(ridgeOctaves, 1, 32);
+            ridgeBias = std::clamp(ridgeBias, 0.0f, 0.95f);
+            ridgePow = std::clamp(ridgePow, 0.1f, 8.0f);
+            ridgeAttenuation = std::clamp(ridgeAttenuation, 0.0f, 1.0f);
+
+            aeolianIterations = std::clamp(aeolianIterations, 0, 100000);
+            aeolianSlab = std::max(1e-4f, aeolianSlab);
+            aeolianHop = std::clamp(aeolianHop, 1, 16);
+            aeolianDepositSand = std::clamp(aeolianDepositSand, 0.0f, 1.0f);
+            aeolianDepositBare = std::clamp(aeolianDepositBare, 0.0f, 1.0f);
+            aeolianSandDepth = std::max(0.0f, aeolianSandDepth);
+            aeolianReposeDeg = std::clamp(aeolianReposeDeg, 5.0f, 60.0f);
         }
     };
 
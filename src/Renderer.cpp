@@ -46,27 +46,26 @@ void Renderer::beginFrame()
 
 void Renderer::drawAllChunks(const ChunkGrid& grid, int W, int H, const Params& P)
 {
-    const int cols = std::max(1, P.chunkCols);
-    const int rows = std::max(1, P.chunkRows);
+    // Taille de la grille affichee : Params peut deja decrire la suivante
+    const int cols = grid.cols;
+    const int rows = grid.rows;
+    if(grid.empty() || grid.chunkW() != W || grid.chunkH() != H) return;
 
     const float stepVisX = P.terrainWidth  + P.chunkGapVisual;
     const float stepVisY = P.terrainLength + P.chunkGapVisual;
 
-    const float centerCols = 0.5f * (cols - 1);
-    const float centerRows = 0.5f * (rows - 1);
-
     for(int r=0;r<rows;++r){
         for(int c=0;c<cols;++c){
-            float visX = (c - centerCols) * stepVisX;
-            float visY = (r - centerRows) * stepVisY;
-            const auto& chunkH = grid.heights[ChunkGrid::index(c,r,cols)];
-            drawMesh(chunkH, W, H, P, visX, visY);
+            float visX = (float)(grid.originX + c) * stepVisX;
+            float visY = (float)(grid.originY + r) * stepVisY;
+            drawMesh(grid.chunk(ChunkGrid::index(c,r,cols)), P, visX, visY);
         }
     }
 }
 
-void Renderer::drawMesh(const std::vector<float>& H, int W, int Hs, const Params& P, float visualOffsetX, float visualOffsetY)
+void Renderer::drawMesh(const ConstChunkView& H, const Params& P, float visualOffsetX, float visualOffsetY)
 {
+    const int W = H.W, Hs = H.H;
     glPushMatrix();
     glTranslatef(P.camPanX, P.camPanY, -P.camZoom);
     glRotatef(P.camRotX,1,0,0);
@@ -101,8 +100,8 @@ void Renderer::drawMesh(const std::vector<float>& H, int W, int Hs, const Params
             float u = (float)i / (W-1);
             float x = (u - 0.5f) * (2.f * halfX);
 
-            float z1=H[(size_t)j*(size_t)W + (size_t)i];
-            float z2=H[(size_t)(j+1)*(size_t)W + (size_t)i];
+            float z1=H.at(i, j);
+            float z2=H.at(i, j+1);
 
             glVertex3f(x, z1, y0);
             glVertex3f(x, z2, y1);
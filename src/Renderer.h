@@ -14,7 +14,7 @@ public:
     void drawAllChunks(const ChunkGrid& grid, int W, int H, const Params& P);
 
 private:
-    static void drawMesh(const std::vector<float>& H, int W, int Hs, const Params& P, float visualOffsetX, float visualOffsetY);
+    static void drawMesh(const ConstChunkView& H, const Params& P, float visualOffsetX, float visualOffsetY);
 };
 
 } // namespace dune
\ No newline at end of file
@@ -0,0 +1,109 @@
+// src/ShardManifest.cpp
+#include "ShardManifest.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace dune {
+
+static std::string hexFloat(float v)
+{
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%a", (double)v);
+    return buf;
+}
+
+bool ShardManifest::save(const ShardManifest& m, const std::string& path)
+{
+    std::ofstream f(path);
+    if(!f) return false;
+
+    char key[32];
+    std::snprintf(key, sizeof(key), "%016" PRIx64, m.gridKey);
+    f << "# dune_cli shard manifest\n";
+    f << "version=1\n";
+    f << "shard=" << m.shard << "\n";
+    f << "shards=" << m.shards << "\n";
+    f << "cols=" << m.cols << "\n";
+    f << "rows=" << m.rows << "\n";
+    f << "W=" << m.W << "\n";
+    f << "H=" << m.H << "\n";
+    f << "rawW=" << m.rawW << "\n";
+    f << "rawH=" << m.rawH << "\n";
+    f << "seamless=" << (m.seamless ? 1 : 0) << "\n";
+    f << "gridKey=" << key << "\n";
+    f << "minH=" << hexFloat(m.minH) << "\n";
+    f << "maxH=" << hexFloat(m.maxH) << "\n";
+    // chunk=c r minH maxH somme fichier
+    for(const Chunk& k : m.chunks){
+        std::snprintf(key, sizeof(key), "%016" PRIx64, k.checksum);
+        f << "chunk=" << k.c << " " << k.r << " " << hexFloat(k.minH) << " " << hexFloat(k.maxH)
+          << " " << key << " " << k.file << "\n";
+    }
+    return (bool)f;
+}
+
+bool ShardManifest::load(ShardManifest& m, const std::string& path)
+{
+    std::ifstream f(path);
+    if(!f) return false;
+
+    m = ShardManifest();
+    int version = 0;
+    std::string line;
+    while(std::getline(f, line)){
+        if(!line.empty() && line.back() == '\r') line.pop_back();
+        if(line.empty() || line[0] == '#') continue;
+        const size_t eq = line.find('=');
+        if(eq == std::string::npos) return false;
+        const std::string k = line.substr(0, eq);
+        const char* v = line.c_str() + eq + 1;
+
+        if(k == "chunk"){
+            Chunk ch;
+            char* end = nullptr;
+            ch.c = (int)std::strtol(v, &end, 10);
+            ch.r = (int)std::strtol(end, &end, 10);
+            ch.minH = std::strtof(end, &end);
+            ch.maxH = std::strtof(end, &end);
+            ch.checksum = std::strtoull(end, &end, 16);
+            while(*end == ' ') end++;
+            if(!*end) return false;
+            ch.file = end;
+            m.chunks.push_back(ch);
+        }
+        else if(k == "version") version = std::atoi(v);
+        else if(k == "shard") m.shard = std::atoi(v);
+        else if(k == "shards") m.shards = std::atoi(v);
+        else if(k == "cols") m.cols = std::atoi(v);
+        else if(k == "rows") m.rows = std::atoi(v);
+        else if(k == "W") m.W = std::atoi(v);
+        else if(k == "H") m.H = std::atoi(v);
+        else if(k == "rawW") m.rawW = std::atoi(v);
+        else if(k == "rawH") m.rawH = std::atoi(v);
+        else if(k == "seamless") m.seamless = std::atoi(v) != 0;
+        else if(k == "gridKey") m.gridKey = std::strtoull(v, nullptr, 16);
+        else if(k == "minH") m.minH = std::strtof(v, nullptr);
+        else if(k == "maxH") m.maxH = std::strtof(v, nullptr);
+    }
+    return version == 1;
+}
+
+uint64_t ShardManifest::checksum(const std::vector<float>& v)
+{
+    uint64_t h = 1469598103934665603ull;
+    const unsigned char* b = (const unsigned char*)v.data();
+    const size_t n = v.size() * sizeof(float);
+    for(size_t i=0;i<n;i++){ h ^= b[i]; h *= 1099511628211ull; }
+    return h;
+}
+
+std::string ShardManifest::path(const std::string& prefix, int shard, int shards)
+{
+    return prefix + "_shard" + std::to_string(shard) + "_of_" + std::to_string(shards) + ".manifest";
+}
+
+} // namespace dune
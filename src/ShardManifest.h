@@ -0,0 +1,38 @@
+// src/ShardManifest.h
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dune {
+
+// Manifeste d'un shard de generation repartie (dune_cli --shard i/N) : les
+// chunks produits, leur bruit brut (fichier .r32) avec min/max et somme de
+// controle, de quoi verifier a la fusion que tous les shards viennent de la
+// meme grille. Texte cle=valeur ; floats en hexadecimal (exacts).
+struct ShardManifest {
+    struct Chunk {
+        int c = 0, r = 0;
+        float minH = 0.f, maxH = 0.f;
+        uint64_t checksum = 0;
+        std::string file;
+    };
+    int shard = 0, shards = 1;
+    int cols = 1, rows = 1;
+    int W = 0, H = 0;          // sortie par chunk
+    int rawW = 0, rawH = 0;    // bruit brut (bordure de raccord comprise)
+    bool seamless = false;
+    uint64_t gridKey = 0;      // TerrainGenerator::gridKey
+    float minH = 1e30f, maxH = -1e30f; // sur les chunks du shard
+    std::vector<Chunk> chunks;
+
+    static bool save(const ShardManifest& m, const std::string& path);
+    static bool load(ShardManifest& m, const std::string& path);
+    // FNV-1a 64 bits des octets des floats
+    static uint64_t checksum(const std::vector<float>& v);
+    // PREFIXE_shardI_of_N.manifest
+    static std::string path(const std::string& prefix, int shard, int shards);
+};
+
+} // namespace dune
@@ -1,112 +1,1390 @@
 // src/TerrainGenerator.cpp
 #include "TerrainGenerator.h"
 
+#include "Aeolian.h"
+
 #include <cmath>
+#include <cstring>
 #include <algorithm>
+#include <functional>
+#include <unordered_map>
 
 namespace dune {
 
-TerrainGenerator::TerrainGenerator(const Noise& noise)
-: noise_(noise)
+TerrainGenerator::TerrainGenerator(const NoiseBackend& noise)
+: noise_(&noise)
 {}
 
-void TerrainGenerator::generateChunkGrid(ChunkGrid& grid, int W, int H, const Params& P) const
+void TerrainGenerator::setNoise(const NoiseBackend& noise)
 {
-    grid.cols = std::max(1, P.chunkCols);
-    grid.rows = std::max(1, P.chunkRows);
-    grid.heights.resize((size_t)grid.cols * (size_t)grid.rows);
+    noise_ = &noise;
+    ++noiseGen_;
+    clearWarpCache();
+}
+
+// Empreinte (FNV-1a 64 bits) des champs lus par une etape ; 0 reserve a
+// "etape a refaire".
+namespace {
+struct Fingerprint {
+    uint64_t h = 1469598103934665603ull;
+    template<class T> Fingerprint& operator<<(const T& v){
+        unsigned char b[sizeof(T)];
+        std::memcpy(b, &v, sizeof(T));
+        for(size_t i=0;i<sizeof(T);i++){ h ^= b[i]; h *= 1099511628211ull; }
+        return *this;
+    }
+    uint64_t value() const { return h ? h : 1; }
+};
+}
 
+// Mise en forme des cretes (Params::ridgedMode) : n in [0,1] du fbm ridged
+// -> t = (n - bias)/(1 - bias) borne a [0,1], r = t^pow, puis creux
+// attenues r * (att + (1 - att) * r). Identite : bias 0, pow 1, att 1.
+namespace {
+struct RidgeShape {
+    bool on = false;
+    float bias = 0.f, inv = 1.f, pw = 1.f, att = 1.f;
+
+    explicit RidgeShape(const Params& P)
+    {
+        if(!P.ridgedMode) return;
+        bias = P.ridgeBias;
+        inv = 1.f / (1.f - bias);
+        pw = P.ridgePow;
+        att = P.ridgeAttenuation;
+        on = bias != 0.f || pw != 1.f || att != 1.f;
+    }
+    // Sur un lot v[0..n), en place. d (optionnel) : derivee par rapport a
+    // n. fast (apercu) : t^pow = 2^(pow*log2 t) en polynomes de degre 3,
+    // ecart relatif ~1e-3. Une boucle par etape, sans appel ni branche dans
+    // celles de l'apercu (GCC les vectorise sans -ffast-math).
+    void apply(float* v, int n, bool fast, float* d = nullptr) const
+    {
+        for(int i=0;i<n;i++) v[i] = std::min(std::max(0.f, (v[i] - bias) * inv), 1.f);
+        // derivee de t : nulle hors de ]0,1[ (bornes)
+        if(d) for(int i=0;i<n;i++) d[i] = v[i] > 0.f && v[i] < 1.f ? inv : 0.f;
+        if(pw != 1.f && fast){
+            // t = 0 : log2Fast(0) = -127, or 2^(pow*-127) n'est pas nul. Le
+            // min avec t*1e30 (nul en t = 0, au-dessus de t^pow des que
+            // t > 1e-30, pow >= 0.1) le ramene a 0 ; un choix t == 0 ? 0 : r
+            // n'est pas vectorise par GCC. pow copie : lu via this sinon
+            // (alias possible avec v, boucle non vectorisee)
+            const float p = pw;
+            for(int i=0;i<n;i++){
+                const float t = v[i];
+                v[i] = std::min(exp2Fast(p * log2Fast(t)), t * 1e30f);
+            }
+        }else if(pw != 1.f){
+            for(int i=0;i<n;i++){
+                const float t = v[i];
+                v[i] = std::pow(t, pw);
+                if(d && t > 0.f) d[i] *= pw * v[i] / t;
+            }
+        }
+        if(d) for(int i=0;i<n;i++) d[i] *= att + 2.f*(1.f - att)*v[i];
+        for(int i=0;i<n;i++) v[i] = v[i] * (att + (1.f - att) * v[i]);
+    }
+
+    static float log2Fast(float x)
+    {
+        uint32_t b;
+        std::memcpy(&b, &x, 4);
+        const float e = (float)((int)(b >> 23) - 127);
+        b = (b & 0x007FFFFFu) | 0x3F800000u;
+        float m;
+        std::memcpy(&m, &b, 4);
+        m -= 1.f;
+        return e + m * (1.42086454f + m * (-0.57725065f + m * 0.15638611f));
+    }
+    // -1100 < x <= 0 ; exposant borne en entier (borner x en float
+    // empeche la vectorisation)
+    static float exp2Fast(float x)
+    {
+        int i = (int)x;
+        i -= (float)i > x;
+        const float f = x - (float)i;
+        i = std::max(i, -126);
+        float p = 1.f + f * (0.69592847f + f * (0.22494631f + f * 0.07912522f));
+        uint32_t b;
+        std::memcpy(&b, &p, 4);
+        b += (uint32_t)i << 23;
+        std::memcpy(&p, &b, 4);
+        return p;
+    }
+};
+}
+
+// out[k*dc] = v[k] * s, min/max cumules dans mn/mx. Huit accumulateurs
+// independants : la reduction se vectorise sans -ffast-math
+static void scaleMinMax(const float* v, int n, float s, float* out, size_t dc, float& mn, float& mx)
+{
+    float lo[8], hi[8];
+    for(int k=0;k<8;k++){ lo[k] = mn; hi[k] = mx; }
+    int i = 0;
+    for(; i + 8 <= n; i += 8){
+        for(int k=0;k<8;k++){
+            const float z = v[i+k] * s;
+            out[(size_t)(i+k)*dc] = z;
+            lo[k] = z < lo[k] ? z : lo[k];
+            hi[k] = z > hi[k] ? z : hi[k];
+        }
+    }
+    for(; i<n; i++){
+        const float z = v[i] * s;
+        out[(size_t)i*dc] = z;
+        lo[0] = std::min(lo[0], z);
+        hi[0] = std::max(hi[0], z);
+    }
+    for(int k=0;k<8;k++){ mn = std::min(mn, lo[k]); mx = std::max(mx, hi[k]); }
+}
+
+static void rotationCS(const Params& P, float& cosR, float& sinR)
+{
+    const float pi = 3.14159265358979323846f;
+    const float rotRad = P.rotationDeg * pi / 180.f;
+    cosR = cos(rotRad); sinR = sin(rotRad);
+}
+
+void TerrainGenerator::colCoords_(const ChunkNoise& cn, int c0, int dc, int n, int W, const Params& P, float* x0)
+{
+    const float halfX = 0.5f * P.terrainWidth;
+    const Seam& sm = cn.seam;
+    for(int k=0;k<n;k++){
+        const int i = c0 + k*dc;
+        float baseX;
+        if(sm.on){
+            // raccord : depuis l'index entier de l'echantillon (ancre en origine)
+            baseX = (float)(sm.anchorX + (double)(sm.kx0 + 2LL*i) * sm.dx);
+        }else{
+            float u = (W>1) ? (float)i / (W - 1) : 0.f;
+            float localBaseX = (u - 0.5f) * (2.f * halfX);
+            baseX = localBaseX + cn.ox;
+        }
+        x0[k] = baseX * P.stretchX;
+    }
+}
+
+void TerrainGenerator::rowCoords_(const ChunkNoise& cn, int j, int n, int Hs, const Params& P,
+                                  float cosR, float sinR, const float* x0, float* xr, float* yr)
+{
+    const float halfY = 0.5f * P.terrainLength;
+    const Seam& sm = cn.seam;
+
+    float v = (Hs>1) ? (float)j / (Hs - 1) : 0.f;
+    float localBaseY = (v - 0.5f) * (2.f * halfY);
+    const float baseY = sm.on ? (float)(sm.anchorY + (double)(sm.ky0 + 2LL*j) * sm.dy) : localBaseY + cn.oy;
+    const float y0 = baseY * P.stretchY;
+    const float ys = y0*sinR, yc = y0*cosR;
+
+    for(int k=0;k<n;k++){
+        const float x = x0[k];
+        xr[k] = x*cosR - ys + cn.offX;
+        yr[k] = x*sinR + yc + cn.offY;
+    }
+}
+
+void TerrainGenerator::rowCoords_(const ChunkNoise& cn, int j, int c0, int dc, int n, int W, int Hs,
+                                  const Params& P, float cosR, float sinR, float* xr, float* yr)
+{
+    colCoords_(cn, c0, dc, n, W, P, xr);
+    rowCoords_(cn, j, n, Hs, P, cosR, sinR, xr, xr, yr);
+}
+
+// Empreinte d'une sortie : cle des etapes + pas du reseau de bruit
+static uint64_t outStamp(uint64_t outKey, int rawStep)
+{
+    Fingerprint f;
+    f << outKey << rawStep;
+    return f.value();
+}
+
+TerrainGenerator::GridLayout TerrainGenerator::layout_(const Params& P)
+{
+    GridLayout L;
+    L.cols = std::max(1, P.chunkCols);
+    L.rows = std::max(1, P.chunkRows);
+    L.centerCols = 0.5f * (L.cols - 1);
+    L.centerRows = 0.5f * (L.rows - 1);
+    L.streaming = P.chunkStreaming;
+    if(P.chunkStreaming){
+        L.cx0 = std::floor(P.camWorldX / P.terrainWidth + 0.5) - (L.cols - 1) / 2;
+        L.cy0 = std::floor(P.camWorldY / P.terrainLength + 0.5) - (L.rows - 1) / 2;
+        L.originX = L.cx0 - P.camWorldX / P.terrainWidth;
+        L.originY = L.cy0 - P.camWorldY / P.terrainLength;
+    }else{
+        L.originX = -L.centerCols;
+        L.originY = -L.centerRows;
+    }
+
+    // Raccord : ancre = worldOrigin (monde etendu : decalee par blocs de 16
+    // chunks autour de la fenetre, pour garder des coordonnees locales
+    // courtes), bordure = rayon des cretes
+    if(P.seamless){
+        L.halo = crestActive(P) ? (int)std::max(1.f, P.crestWidth) : 0;
+        if(P.largeWorld && P.chunkStreaming){
+            L.anchorCX = std::floor(L.cx0 / 16.0) * 16.0;
+            L.anchorCY = std::floor(L.cy0 / 16.0) * 16.0;
+        }
+    }
+    return L;
+}
+
+void TerrainGenerator::initJob_(ChunkJob& job, const GridLayout& L, int c, int r, int W, int H,
+                                const Params& P)
+{
     const float stepX = P.terrainWidth;
     const float stepY = P.terrainLength;
-    const float centerCols = 0.5f * (grid.cols - 1);
-    const float centerRows = 0.5f * (grid.rows - 1);
+    const double px = L.colPos(c), py = L.rowPos(r);
+    job.W = W; job.Hs = H;
+    job.Wo = W; job.Ho = H;
+    if(P.largeWorld){
+        // origines en double : pas de perte aux grands indices de chunk
+        job.ox = P.worldOriginX + px * (double)stepX;
+        job.oy = P.worldOriginY + py * (double)stepY;
+    }else{
+        job.ox = (float)px * stepX + (float)P.worldOriginX;
+        job.oy = (float)py * stepY + (float)P.worldOriginY;
+    }
+    if(P.seamless){
+        Seam& sm = job.seam;
+        const int halo = L.halo;
+        sm.on = true;
+        sm.halo = halo;
+        sm.anchorX = P.worldOriginX + L.anchorCX * (double)stepX;
+        sm.anchorY = P.worldOriginY + L.anchorCY * (double)stepY;
+        sm.dx = stepX / (2.0 * (W - 1));
+        sm.dy = stepY / (2.0 * (H - 1));
+        // centre du chunk a 2*pos*(W-1) demi-pas de l'ancre
+        sm.kx0 = std::llround(2.0 * (px - L.anchorCX)) * (W - 1) - (W - 1) - 2LL*halo;
+        sm.ky0 = std::llround(2.0 * (py - L.anchorCY)) * (H - 1) - (H - 1) - 2LL*halo;
+        job.W = W + 2*halo;
+        job.Hs = H + 2*halo;
+    }
+}
+
+bool TerrainGenerator::generateChunkGrid(ChunkGrid& grid, int W, int H, const Params& P, int step,
+                                         const std::atomic<bool>* cancel) const
+{
+    std::lock_guard<std::mutex> lock(stageMu_);
+
+    const int cols = std::max(1, P.chunkCols);
+    const int rows = std::max(1, P.chunkRows);
+    const size_t n = (size_t)cols * (size_t)rows;
+    bool changed = grid.cols != cols || grid.rows != rows;
+    grid.cols = cols;
+    grid.rows = rows;
+
+    const GridLayout L = layout_(P);
+    grid.originX = L.originX;
+    grid.originY = L.originY;
+
+    if(!stageCache_) stages_.clear();
+    const uint64_t tick = ++stageTick_;
+
+    // Sans cache, etapes temporaires pour le raccord
+    const bool seamless = P.seamless;
+    std::vector<ChunkStages> local(seamless && !stageCache_ ? n : 0);
+
+    std::vector<std::unique_ptr<ChunkJob>> jobs;
+    jobs.reserve(n);
+    for(int r=0;r<rows;++r){
+        for(int c=0;c<cols;++c){
+            auto job = std::make_unique<ChunkJob>();
+            const int idx = ChunkGrid::index(c,r,cols);
+            initJob_(*job, L, c, r, W, H, P);
+            job->cancel = cancel;
+            if(stageCache_){
+                ChunkStages& st = stages_[{job->ox, job->oy}];
+                st.lastUse = tick;
+                job->st = &st;
+            }else if(seamless){
+                job->st = &local[idx];
+            }
+            if(job->st) job->lat.step = std::max(1, step);
+            jobs.push_back(std::move(job));
+        }
+    }
+
+    // Cles d'etapes et sortie attendue (reseau deja plus fin garde tel quel).
+    // Raccord : le recentrage depend du bruit de toute la grille.
+    std::vector<uint64_t> want(n, 0);
+    std::vector<int> rawStep(n, 1);
+    Fingerprint norm;
+    for(size_t idx=0;idx<n;idx++){
+        ChunkJob& job = *jobs[idx];
+        if(!job.st) continue;
+        stageKeys_(job, P, 0);
+        const bool keep = job.st->rawKey == job.rawKey && job.st->rawStep <= job.lat.step;
+        rawStep[idx] = keep ? job.st->rawStep : job.lat.step;
+        norm << job.rawKey << rawStep[idx];
+    }
+    for(size_t idx=0;idx<n;idx++){
+        ChunkJob& job = *jobs[idx];
+        if(!job.st) continue;
+        if(seamless) stageKeys_(job, P, norm.value());
+        if(stageCache_) want[idx] = outStamp(job.outKey, rawStep[idx]);
+    }
+
+    // Chunks deja calcules ailleurs dans la grille (redimensionnement, fenetre
+    // deplacee) : leur contenu est deplace a sa nouvelle place dans le bloc ;
+    // les autres places sont a recalculer (memoire deja allouee). Grille
+    // quantifiee : chunks repris tels que stockes (16 bits), sauf changement
+    // de mode de stockage ; tout repris a sa place : rien a redisposer
+    std::vector<int> from;
+    bool inPlace = false;
+    if(stageCache_ && grid.chunkW() == W && grid.chunkH() == H && grid.quantized() == P.quantizedStorage){
+        std::unordered_map<uint64_t, int> byStamp;
+        for(size_t k=0;k<grid.stamps.size();k++) if(grid.stamps[k]) byStamp[grid.stamps[k]] = (int)k;
+        from.assign(n, -1);
+        inPlace = grid.chunkCount() == n;
+        for(size_t idx=0;idx<n;idx++){
+            auto it = byStamp.find(want[idx]);
+            inPlace &= it != byStamp.end() && (size_t)it->second == idx;
+            if(it == byStamp.end()) continue;
+            from[idx] = it->second;
+            changed |= (size_t)it->second != idx;
+        }
+    }
+    if(!inPlace) grid.reshape(cols, rows, W, H, from, P.quantizedStorage);
 
-    for(int r=0;r<grid.rows;++r){
-        for(int c=0;c<grid.cols;++c){
-            float offsetX = (c - centerCols) * stepX;
-            float offsetY = (r - centerRows) * stepY;
-            generateHeights(grid.heights[ChunkGrid::index(c,r,grid.cols)], W, H, P, offsetX, offsetY);
+    // Grille quantifiee : seuls les chunks a reecrire (empreinte differente de
+    // la sortie attendue) ont des floats de travail, encodes a la fin ; les
+    // autres restent en 16 bits, sans sortie
+    const bool quantized = P.quantizedStorage;
+    const size_t No = (size_t)W*(size_t)H;
+    std::vector<char> dirty(n, 1);
+    std::vector<float> scratch;
+    if(quantized){
+        size_t k = 0;
+        for(size_t idx=0;idx<n;idx++){
+            dirty[idx] = !stageCache_ || !want[idx] || grid.stamps[idx] != want[idx];
+            k += dirty[idx];
         }
+        scratch.resize(k * No);
+    }
+    for(size_t idx=0, k=0;idx<n;idx++){
+        if(quantized){
+            jobs[idx]->out = dirty[idx] ? scratch.data() + (k++)*No : nullptr;
+            jobs[idx]->ldo = (size_t)W;
+        }else{
+            const ChunkView v = grid.writableChunk((int)idx);
+            jobs[idx]->out = v.data;
+            jobs[idx]->ldo = v.stride;
+        }
+        if(jobs[idx]->st) jobs[idx]->stamp = &grid.stamps[idx];
+    }
+    runChunks_(jobs, P, cancel);
+    if(!stageCache_) std::fill(grid.stamps.begin(), grid.stamps.end(), 0);
+    if(stageCache_) evictStages_((size_t)std::max(0, P.chunkCacheMB) << 20);
+
+    // Pyramides (depuis les floats, avant quantification) : chunks reecrits
+    // ou sans le bon nombre de niveaux. Annulation : pyramides des chunks
+    // reecrits videes, refaites au prochain appel. Chunks reecrits encodes
+    // meme annules (empreinte posee : sortie complete).
+    const bool cancelled = cancel && cancel->load();
+    const int levels = ChunkGrid::mipCount(W, H, P.mipLevels);
+    const std::shared_ptr<ThreadPool> pool = threadPool_(P);
+    auto finish = [&](int idx){
+        const ChunkJob& job = *jobs[idx];
+        const ConstChunkView src = quantized && job.out ? ConstChunkView(job.out, W, H, job.ldo) : ConstChunkView();
+        if(cancelled){ if(job.changed) grid.buildMips(idx, 0); }
+        else if(job.changed || (int)grid.mips(idx).size() != levels) grid.buildMips(idx, levels, src);
+        if(job.changed && !src.empty()) grid.quantizeChunk(idx, src);
+    };
+    if(pool) pool->parallelFor((int)n, finish);
+    else for(int idx=0;idx<(int)n;idx++) finish(idx);
+
+    for(const auto& job : jobs) changed |= job->changed;
+    return changed && !cancelled;
+}
+
+size_t TerrainGenerator::outOfCoreChunkBytes(int W, int H, const Params& P)
+{
+    const int halo = layout_(P).halo;
+    const size_t No = (size_t)W*(size_t)H;
+    const size_t Ne = (size_t)(W + 2*halo)*(size_t)(H + 2*halo);
+    size_t floats = No;                                      // sortie (bruit sur place hors raccord)
+    if(P.seamless) floats += Ne * (crestActive(P) ? 2 : 1);  // raw (+ rec)
+    if(P.warpEnabled) floats += 2 * (P.seamless ? Ne : No);  // champ de warp
+    return floats * sizeof(float);
+}
+
+bool TerrainGenerator::windows_(const GridLayout& L, size_t first, size_t last, size_t win, int W, int H,
+                                const Params& P, bool stages, std::vector<std::vector<float>>& out,
+                                const std::function<bool(std::vector<std::unique_ptr<ChunkJob>>&, size_t)>& fn) const
+{
+    // Buffers de la fenetre, reutilises d'une fenetre a l'autre
+    out.resize(win);
+    std::vector<ChunkStages> local(stages ? win : 0);
+    std::vector<uint64_t> stamps(win, 0);
+    std::vector<std::unique_ptr<ChunkJob>> jobs;
+    for(size_t i0=first;i0<last;i0+=win){
+        jobs.clear();
+        for(size_t i=0;i<win && i0+i<last;i++){
+            auto job = std::make_unique<ChunkJob>();
+            initJob_(*job, L, (int)((i0+i) % L.cols), (int)((i0+i) / L.cols), W, H, P);
+            out[i].resize((size_t)W*(size_t)H);
+            job->out = out[i].data();
+            job->ldo = (size_t)W;
+            if(stages){
+                // etapes invalidees (buffers gardes) : tout est refait
+                ChunkStages& st = local[i];
+                st.rawKey = st.recKey = st.satKey = 0;
+                st.warp.reset();
+                stamps[i] = 0;
+                job->st = &st;
+                job->stamp = &stamps[i];
+                stageKeys_(*job, P, 0);
+            }
+            jobs.push_back(std::move(job));
+        }
+        if(!fn(jobs, i0)) return false;
+    }
+    return true;
+}
+
+bool TerrainGenerator::generateOutOfCore(int W, int H, const Params& P, size_t budgetBytes,
+                                         const ChunkSink& sink) const
+{
+    std::lock_guard<std::mutex> lock(stageMu_);
+
+    const GridLayout L = layout_(P);
+    const size_t n = (size_t)L.cols * (size_t)L.rows;
+    const size_t win = std::clamp(budgetBytes / outOfCoreChunkBytes(W, H, P), (size_t)1, n);
+    const bool seamless = P.seamless;
+    std::vector<std::vector<float>> out;
+
+    SeamPass pass;
+    if(seamless){
+        pass.rawOnly = true;
+        windows_(L, 0, n, win, W, H, P, true, out, [&](std::vector<std::unique_ptr<ChunkJob>>& jobs, size_t){
+            runChunks_(jobs, P, nullptr, &pass);
+            return true;
+        });
+        pass.rawOnly = false;
+    }
+    return windows_(L, 0, n, win, W, H, P, seamless, out, [&](std::vector<std::unique_ptr<ChunkJob>>& jobs, size_t i0){
+        runChunks_(jobs, P, nullptr, seamless ? &pass : nullptr);
+        for(size_t i=0;i<jobs.size();i++){
+            if(!sink((int)((i0+i) % L.cols), (int)((i0+i) / L.cols), out[i])) return false;
+        }
+        return true;
+    });
+}
+
+void TerrainGenerator::shardRange(int shard, int shards, int nChunks, int& first, int& last)
+{
+    first = (int)((long long)nChunks * shard / shards);
+    last = (int)((long long)nChunks * (shard + 1) / shards);
+}
+
+uint64_t TerrainGenerator::gridKey(int W, int H, const Params& P) const
+{
+    // cle de sortie des chunks des deux coins : tout ce qui change les
+    // hauteurs. noiseGen_ (dans outKey) ne compte que les changements de
+    // moteur du processus : moteur et graine du backend hashes ici
+    const GridLayout L = layout_(P);
+    Fingerprint f;
+    f << (int)noise_->engine() << noise_->seed() << L.cols << L.rows;
+    for(int k=0;k<2;k++){
+        ChunkJob job;
+        initJob_(job, L, k ? L.cols - 1 : 0, k ? L.rows - 1 : 0, W, H, P);
+        stageKeys_(job, P, 0);
+        f << job.outKey;
+    }
+    return f.value();
+}
+
+bool TerrainGenerator::generateShard(int W, int H, const Params& P, int shard, int shards, size_t budgetBytes,
+                                     const RawSink& sink) const
+{
+    std::lock_guard<std::mutex> lock(stageMu_);
+
+    const GridLayout L = layout_(P);
+    int first, last;
+    shardRange(shard, shards, L.cols * L.rows, first, last);
+    if(first >= last) return true;
+    const size_t win = std::clamp(budgetBytes / outOfCoreChunkBytes(W, H, P), (size_t)1, (size_t)(last - first));
+    std::vector<std::vector<float>> out;
+
+    SeamPass pass;
+    pass.rawOnly = true;
+    return windows_(L, first, last, win, W, H, P, true, out, [&](std::vector<std::unique_ptr<ChunkJob>>& jobs, size_t i0){
+        runChunks_(jobs, P, nullptr, &pass);
+        for(size_t i=0;i<jobs.size();i++){
+            const ChunkJob& job = *jobs[i];
+            if(!sink((int)((i0+i) % L.cols), (int)((i0+i) / L.cols), job.st->raw, job.W, job.Hs,
+                     job.st->minH, job.st->maxH)) return false;
+        }
+        return true;
+    });
+}
+
+bool TerrainGenerator::finishChunk(std::vector<float>& out, std::vector<float>& raw, int c, int r, int W, int H,
+                                   const Params& P, float minH, float maxH) const
+{
+    const GridLayout L = layout_(P);
+    ChunkJob job;
+    initJob_(job, L, c, r, W, H, P);
+    if(raw.size() != (size_t)job.W*(size_t)job.Hs) return false;
+    job.tilesX = (job.W + kTile - 1) / kTile;
+    job.tilesY = (job.Hs + kTile - 1) / kTile;
+    stageKeys_(job, P, 0);
+
+    // bruit deja calcule : etape brute valide, recentrage et cretes a faire
+    ChunkStages st;
+    st.raw.swap(raw);
+    st.rawKey = job.rawKey;
+    st.rawStep = 1;
+    uint64_t stamp = 0;
+    job.st = &st;
+    job.stamp = &stamp;
+    out.resize((size_t)job.Wo*(size_t)job.Ho);
+    job.out = out.data();
+    job.ldo = (size_t)job.Wo;
+
+    const std::shared_ptr<ThreadPool> pool = threadPool_(P);
+    const ForEach forEach = [&](int n, const std::function<void(int)>& fn){
+        if(pool) pool->parallelFor(n, fn);
+        else for(int k=0;k<n;k++) fn(k);
+    };
+    outPhase_(job, P, forEach, minH, maxH);
+    st.raw.swap(raw);
+    return true;
+}
+
+void TerrainGenerator::setStageCache(bool on)
+{
+    std::lock_guard<std::mutex> lock(stageMu_);
+    stageCache_ = on;
+    if(!on) stages_.clear();
+}
+
+void TerrainGenerator::clearStageCache()
+{
+    std::lock_guard<std::mutex> lock(stageMu_);
+    stages_.clear();
+}
+
+size_t TerrainGenerator::ChunkStages::bytes() const
+{
+    return (raw.size() + rec.size()) * sizeof(float) + sat.size() * sizeof(double)
+         + (warp ? warp->bytes() : 0);
+}
+
+size_t TerrainGenerator::stageCacheBytes() const
+{
+    std::lock_guard<std::mutex> lock(stageMu_);
+    size_t total = 0;
+    for(const auto& e : stages_) total += e.second.bytes();
+    return total;
+}
+
+void TerrainGenerator::evictStages_(size_t budget) const
+{
+    size_t total = 0;
+    std::vector<std::pair<uint64_t, std::pair<double,double>>> old;
+    for(const auto& e : stages_){
+        total += e.second.bytes();
+        if(e.second.lastUse != stageTick_) old.push_back({e.second.lastUse, e.first});
+    }
+    // les moins recemment utilises d'abord (chunks loin de la camera)
+    std::sort(old.begin(), old.end());
+    for(const auto& v : old){
+        if(total <= budget) break;
+        auto it = stages_.find(v.second);
+        total -= it->second.bytes();
+        stages_.erase(it);
     }
 }
 
 void TerrainGenerator::generateHeights(
     std::vector<float>& out, int W, int Hs, const Params& P,
-    float chunkWorldOffsetX, float chunkWorldOffsetY) const
+    double chunkWorldOffsetX, double chunkWorldOffsetY,
+    std::vector<float>* outGrad) const
 {
+    std::vector<std::unique_ptr<ChunkJob>> jobs;
+    jobs.push_back(std::make_unique<ChunkJob>());
+    ChunkJob& job = *jobs[0];
     out.resize((size_t)W*(size_t)Hs);
+    job.out = out.data();
+    job.ldo = (size_t)W;
+    job.W = W; job.Hs = Hs;
+    job.Wo = W; job.Ho = Hs;
+    job.ox = chunkWorldOffsetX; job.oy = chunkWorldOffsetY;
+    if(outGrad){
+        outGrad->resize((size_t)W*(size_t)Hs*2);
+        job.grad = outGrad->data();
+    }
+    runChunks_(jobs, P);
+}
 
-    float minH= 1e30f, maxH = -1e30f;
+std::shared_ptr<ThreadPool> TerrainGenerator::threadPool_(const Params& P) const
+{
+    const int n = P.threadCount > 0 ? P.threadCount : ThreadPool::defaultThreadCount();
+    if(n <= 1) return nullptr;
+    std::lock_guard<std::mutex> lock(poolMu_);
+    if(!pool_ || pool_->size() != n) pool_ = std::make_shared<ThreadPool>(n);
+    return pool_;
+}
 
-    const float pi = 3.14159265358979323846f;
-    const float rotRad = P.rotationDeg * pi / 180.f;
-    const float cosR = cos(rotRad), sinR = sin(rotRad);
+void TerrainGenerator::stageKeys_(ChunkJob& job, const Params& P, uint64_t normKey) const
+{
+    // bruit brut : tout ce que lisent setupChunk_, rowCoords_ et heightTile_
+    Fingerprint f;
+    f << noiseGen_ << (preview_ && !job.grad && !P.largeWorld) << job.W << job.Hs << job.ox << job.oy
+      << job.seam.on << job.seam.halo << job.seam.anchorX << job.seam.anchorY
+      << P.largeWorld << P.terrainWidth << P.terrainLength
+      << P.stretchX << P.stretchY << P.rotationDeg << P.noiseOffsetX << P.noiseOffsetY << P.noiseZoom
+      << P.ridgedMode << P.noiseOctaves() << P.noiseLacunarity() << P.noiseGain() << P.freq << P.amp
+      << P.warpEnabled << P.warpFreq << (P.warpEnabled ? P.warpAmp : 0.f);
+    if(P.ridgedMode) f << P.ridgeBias << P.ridgePow << P.ridgeAttenuation;
+    job.rawKey = f.value();
+    f << P.invertZ << normKey; // raccord : min/max de toute la grille
+    job.recKey = f.value();
+    if(crestActive(P)) f << P.crestSmoothing << P.crestSharpen << P.crestWidth;
+    if(Aeolian::active(P))
+        f << P.aeolianIterations << P.aeolianSlab << P.aeolianHop << P.aeolianDepositSand
+          << P.aeolianDepositBare << P.aeolianSandDepth << P.aeolianReposeDeg << P.aeolianSeed;
+    job.outKey = f.value();
+}
 
-    const float halfX = 0.5f * P.terrainWidth;
-    const float halfY = 0.5f * P.terrainLength;
+void TerrainGenerator::beginChunk_(ChunkJob& job, const Params& P) const
+{
+    // Dispatch une fois par chunk : mode + octaves -> noyau, warp -> boucle
+    // (l'apercu ne fournit ni gradient ni monde etendu : pleine qualite)
+    setupChunk_(job.cn, P, job.ox, job.oy, preview_ && !job.grad && !P.largeWorld, job.seam);
 
-    for(int j=0;j<Hs;j++){
-        float v = (Hs>1) ? (float)j / (Hs - 1) : 0.f;
-        float localBaseY = (v - 0.5f) * (2.f * halfY);
+    // Warp sans gradient : champ partiel du raffinement en cours, sinon du
+    // cache, sinon rempli par les tuiles
+    if(P.warpEnabled && !job.grad){
+        const WarpKey key = warpKey_(job.W, job.Hs, P, job.ox, job.oy, job.seam);
+        if(job.lat.from && job.st && job.st->warp){
+            job.fresh = job.st->warp;
+            job.wf = job.fresh;
+        }else{
+            job.wf = lookupWarp_(key, job.cn.preview);
+        }
+        if(!job.wf){
+            job.lat.from = 0; // champ neuf : tout le reseau `step` a calculer
+            job.fresh = std::make_shared<WarpField>();
+            job.fresh->key = key;
+            job.fresh->preview = job.cn.preview;
+            size_t n = (size_t)job.W*(size_t)job.Hs;
+            if(job.cn.preview && !job.seam.on){
+                // raccord : champ complet (memes points chez les deux voisins)
+                const int s = kPreviewWarpStep;
+                job.fresh->step = s;
+                job.fresh->cw = (job.W - 1) / s + 2;
+                n = (size_t)job.fresh->cw * (size_t)((job.Hs - 1) / s + 2);
+            }
+            job.fresh->wx.resize(n);
+            job.fresh->wy.resize(n);
+            job.wf = job.fresh;
+        }
+    }
 
-        for(int i=0;i<W;i++){
-            float u = (W>1) ? (float)i / (W - 1) : 0.f;
-            float localBaseX = (u - 0.5f) * (2.f * halfX);
+    const int nt = job.tilesX * job.tilesY;
+    job.tileMin.assign(nt, 1e30f);
+    job.tileMax.assign(nt, -1e30f);
+}
+
+// plus petit i >= a avec i = k (mod m)
+static int firstCongruent(int a, int k, int m)
+{
+    return a + ((k - a % m) % m + m) % m;
+}
+
+void TerrainGenerator::forRuns_(const Lattice& lat, int i0, int i1, int j0, int j1,
+                                const std::function<void(int,int,int,int)>& fn)
+{
+    const int s = lat.step, f = lat.from;
+    for(int j=firstCongruent(j0, 0, s); j<j1; j+=s){
+        // ligne deja au reseau `from` : seules les colonnes hors de ce reseau
+        if(f && j % f == 0){
+            for(int k=s;k<f;k+=s){
+                const int c0 = firstCongruent(i0, k, f);
+                if(c0 < i1) fn(j, c0, f, (i1 - c0 + f - 1) / f);
+            }
+        }else{
+            const int c0 = firstCongruent(i0, 0, s);
+            if(c0 < i1) fn(j, c0, s, (i1 - c0 + s - 1) / s);
+        }
+    }
+}
+
+void TerrainGenerator::tileRect_(const ChunkJob& job, int t, int& i0, int& i1, int& j0, int& j1)
+{
+    i0 = (t % job.tilesX) * kTile; i1 = std::min(job.W,  i0 + kTile);
+    j0 = (t / job.tilesX) * kTile; j1 = std::min(job.Hs, j0 + kTile);
+}
+
+void TerrainGenerator::genTile_(ChunkJob& job, const Params& P, int t, bool band) const
+{
+    const int W = job.W, Hs = job.Hs;
+    int i0, i1, j0, j1;
+    tileRect_(job, t, i0, i1, j0, j1);
+    if(band) i1 = W;
+    float& minH = job.tileMin[t];
+    float& maxH = job.tileMax[t];
+    if(job.fresh && job.fresh->step == 1) fillWarpTile_(*job.fresh, P, job.cn, job.lat, i0, i1, j0, j1);
+
+    if(job.grad){
+        if(P.warpEnabled) heightTile_<true, true> (job.raw, job.ldr, W, Hs, i0, i1, j0, j1, job.lat, P, job.cn, nullptr, job.grad, minH, maxH);
+        else              heightTile_<false,true> (job.raw, job.ldr, W, Hs, i0, i1, j0, j1, job.lat, P, job.cn, nullptr, job.grad, minH, maxH);
+    }else if(P.warpEnabled){
+        heightTile_<true, false>(job.raw, job.ldr, W, Hs, i0, i1, j0, j1, job.lat, P, job.cn, job.wf.get(), nullptr, minH, maxH);
+    }else{
+        heightTile_<false,false>(job.raw, job.ldr, W, Hs, i0, i1, j0, j1, job.lat, P, job.cn, nullptr, nullptr, minH, maxH);
+    }
+}
+
+void TerrainGenerator::runChunks_(std::vector<std::unique_ptr<ChunkJob>>& jobs, const Params& P,
+                                   const std::atomic<bool>* cancel, SeamPass* pass) const
+{
+    const std::shared_ptr<ThreadPool> pool = threadPool_(P);
+    const int threads = pool ? pool->size() : 1;
+    const int nChunks = (int)jobs.size();
+
+    // Une tache par chunk, qui lance ses tuiles dans le meme pool : le vol de
+    // travail repartit les tuiles cheres (cretes denses) entre les threads
+    // libres, meme avec moins de chunks que de coeurs. Annulation testee
+    // avant chaque tache (chunk, tuile, bande).
+    const ForEach forEach = [&](int n, const std::function<void(int)>& fn){
+        auto run = [&](int k){
+            if(cancel && cancel->load(std::memory_order_relaxed)) return;
+            fn(k);
+        };
+        if(pool) pool->parallelFor(n, run);
+        else for(int k=0;k<n;k++) run(k);
+    };
+
+    for(auto& job : jobs){
+        job->tilesX = (job->W + kTile - 1) / kTile;
+        job->tilesY = (job->Hs + kTile - 1) / kTile;
+    }
+
+    // Raccord : deux phases, min/max reduits sur toute la grille entre les
+    // deux. Bruit seul (pass->rawOnly) : premiere phase, avec ou sans raccord.
+    if(nChunks > 0 && (jobs[0]->seam.on || (pass && pass->rawOnly))){
+        forEach(nChunks, [&](int c){ rawPhase_(*jobs[c], P, forEach); });
+        float minH = 1e30f, maxH = -1e30f;
+        for(const auto& job : jobs){ minH = std::min(minH, job->st->minH); maxH = std::max(maxH, job->st->maxH); }
+        if(pass && pass->rawOnly){
+            pass->minH = std::min(pass->minH, minH);
+            pass->maxH = std::max(pass->maxH, maxH);
+            return;
+        }
+        if(pass){ minH = pass->minH; maxH = pass->maxH; }
+        forEach(nChunks, [&](int c){ outPhase_(*jobs[c], P, forEach, minH, maxH); });
+        return;
+    }
+
+    forEach(nChunks, [&](int c){
+        ChunkJob& job = *jobs[c];
+        if(job.st){
+            rawPhase_(job, P, forEach);
+            if(!cancelled_(job)) outPhase_(job, P, forEach, job.st->minH, job.st->maxH);
+        }else{
+            // ~2 bandes de cretes par thread au total (halos par bande)
+            const int bands = std::clamp((2*threads + nChunks - 1) / nChunks, 1, job.tilesY);
+            streamedChunk_(job, P, forEach, bands);
+            aeolian_(job, P, forEach);
+        }
+    });
+}
+
+void TerrainGenerator::rawStage_(ChunkJob& job, const Params& P, const ForEach& forEach,
+                                 float& minH, float& maxH) const
+{
+    const int nt = job.tilesX * job.tilesY;
+    beginChunk_(job, P);
+    if(job.fresh && job.fresh->step > 1) fillPreviewWarp_(*job.fresh, P, job.cn, forEach);
+    // apercu sans warp a remplir par tuile : bandes de kTile lignes pleine
+    // largeur, le brut s'ecrit par lignes entieres (sequentiel, le prefetch
+    // materiel suit) ; min/max de la bande dans sa premiere tuile
+    const bool band = job.cn.preview && !(job.fresh && job.fresh->step == 1);
+    if(band) forEach(job.tilesY, [&](int b){ genTile_(job, P, b * job.tilesX, true); });
+    else     forEach(nt, [&](int t){ genTile_(job, P, t); });
+    if(cancelled_(job)){
+        // champ troue : ni publie ni garde
+        if(job.st) job.st->warp.reset();
+        job.fresh.reset();
+    }else if(job.fresh){
+        // champ partiel (reseau grossier) : garde pour le palier suivant ;
+        // champ d'apercu complet des le premier palier
+        if(job.lat.step > 1 && job.st && job.fresh->step == 1) job.st->warp = job.fresh;
+        else{ storeWarp_(job.fresh); if(job.st) job.st->warp.reset(); }
+        job.fresh.reset();
+    }
+    job.wf.reset(); // hors cache : libere des ce chunk fini, pas en fin de grille
+    minH = 1e30f; maxH = -1e30f;
+    for(int t=0;t<nt;t++){ minH = std::min(minH, job.tileMin[t]); maxH = std::max(maxH, job.tileMax[t]); }
+}
+
+// invertZ + recentrage vertical de src vers dst (peut etre le meme buffer si
+// step == 1) ; negation exacte : memes valeurs que si le signe etait applique
+// au bruit. step > 1 : src n'est lu qu'aux points du reseau, dst interpole
+// (bilineaire) en deux temps : lignes du reseau, puis lignes intermediaires
+// par interpolation verticale contigue. Au-dela du dernier point (bord non
+// multiple du pas), valeur du dernier point.
+void TerrainGenerator::recenter_(const ChunkJob& job, const Params& P, const ForEach& forEach,
+                                 const float* src, size_t lds, float* dst, size_t ldd,
+                                 float rawMin, float rawMax, int step)
+{
+    const bool inv = P.invertZ;
+    const float minH = inv ? -rawMax : rawMin;
+    const float maxH = inv ? -rawMin : rawMax;
+    const float offset = -(minH+maxH)/4.f;
+    const int W = job.W, nt = job.tilesX * job.tilesY;
+    if(step == 1){
+        forEach(nt, [&](int t){
+            int i0, i1, j0, j1;
+            tileRect_(job, t, i0, i1, j0, j1);
+            for(int j=j0;j<j1;j++){
+                const float* r = src + (size_t)j*lds;
+                float* h = dst + (size_t)j*ldd;
+                if(inv) for(int i=i0;i<i1;i++) h[i] = r[i]*-1.f + offset;
+                else    for(int i=i0;i<i1;i++) h[i] = r[i] + offset;
+            }
+        });
+        return;
+    }
+
+    const int s = step;
+    const int lx = (W - 1) / s * s, ly = (job.Hs - 1) / s * s;
+    const float stepInv = 1.f / s;
+    auto f = [&](float v){ return (inv ? v*-1.f : v) + offset; };
+    forEach(nt, [&](int t){
+        int i0, i1, j0, j1;
+        tileRect_(job, t, i0, i1, j0, j1);
+        for(int j=(j0 + s - 1) / s * s; j<j1; j+=s){
+            const float* r = src + (size_t)j*lds;
+            float* h = dst + (size_t)j*ldd;
+            for(int ia=i0 / s * s; ia<i1; ia+=s){
+                const int ib = std::min(ia + s, lx);
+                const float a = f(r[ia]), d = f(r[ib]) - a;
+                const int xe = std::min(i1, ia + s);
+                for(int i=std::max(i0, ia); i<xe; i++) h[i] = ib > ia ? a + d * ((i - ia) * stepInv) : a;
+            }
+        }
+    });
+    forEach(nt, [&](int t){
+        int i0, i1, j0, j1;
+        tileRect_(job, t, i0, i1, j0, j1);
+        for(int j=j0;j<j1;j++){
+            if(j % s == 0) continue;
+            const int ja = std::min(j / s * s, ly), jb = std::min(ja + s, ly);
+            const float ty = jb > ja ? (j - ja) * stepInv : 0.f;
+            const float* ha = dst + (size_t)ja*ldd;
+            const float* hb = dst + (size_t)jb*ldd;
+            float* h = dst + (size_t)j*ldd;
+            for(int i=i0;i<i1;i++) h[i] = ha[i] + (hb[i] - ha[i]) * ty;
+        }
+    });
+}
+
+void TerrainGenerator::rawPhase_(ChunkJob& job, const Params& P, const ForEach& forEach) const
+{
+    ChunkStages& st = *job.st;
+
+    // 1) warp + bruit. Progressif : seuls les points du reseau `step` absents
+    // du reseau deja calcule (rawStep, multiple de step) ; raw n'est valide
+    // qu'aux points du reseau, le reste est interpole au recentrage.
+    const int step = job.lat.step;
+    if(st.rawKey != job.rawKey || st.rawStep > step){
+        const bool refine = st.rawKey == job.rawKey && st.rawStep % step == 0;
+        job.lat.from = refine ? st.rawStep : 0;
+        if(!refine) st.warp.reset();
+        st.rawKey = st.recKey = 0;
+        st.raw.resize((size_t)job.W*(size_t)job.Hs);
+        job.raw = st.raw.data();
+        job.ldr = (size_t)job.W;
+        float minH, maxH;
+        rawStage_(job, P, forEach, minH, maxH);
+        // le reseau precedent est un sous-ensemble : min/max cumules
+        if(job.lat.from){ minH = std::min(minH, st.minH); maxH = std::max(maxH, st.maxH); }
+        if(cancelled_(job)) return;
+        st.minH = minH; st.maxH = maxH;
+        st.rawKey = job.rawKey;
+        st.rawStep = step;
+    }
+}
+
+void TerrainGenerator::outPhase_(ChunkJob& job, const Params& P, const ForEach& forEach,
+                                 float minH, float maxH) const
+{
+    ChunkStages& st = *job.st;
+    const size_t N = (size_t)job.W*(size_t)job.Hs;
+    const bool crest = crestActive(P);
+
+    // Sans cretes (donc sans bordure) la sortie est le recentrage lui-meme :
+    // ecrit directement, rec libere (refait si les cretes reviennent)
+    const uint64_t stamp = outStamp(job.outKey, st.rawStep);
+    if(!crest){
+        if(*job.stamp != stamp){
+            *job.stamp = 0;
+            recenter_(job, P, forEach, st.raw.data(), (size_t)job.W, job.out, job.ldo, minH, maxH, st.rawStep);
+            if(st.rawStep == 1) aeolian_(job, P, forEach);
+            if(cancelled_(job)) return;
+            std::vector<float>().swap(st.rec);
+            std::vector<double>().swap(st.sat);
+            st.recKey = st.satKey = 0;
+            *job.stamp = stamp;
+            job.changed = true;
+        }
+        return;
+    }
+
+    // 2) invertZ + recentrage
+    if(st.recKey != job.recKey){
+        st.recKey = st.satKey = 0;
+        st.rec.resize(N);
+        recenter_(job, P, forEach, st.raw.data(), (size_t)job.W, st.rec.data(), (size_t)job.W, minH, maxH, st.rawStep);
+        if(cancelled_(job)) return;
+        st.recKey = job.recKey;
+    }
+
+    // 3) cretes -> sortie (lit rec seulement : copie et cretes par tuile).
+    // Raccord : sortie = interieur de rec ; somme directe seulement (meme
+    // ordre monde chez les deux voisins, pas la table qui part du coin du chunk)
+    const int h = job.seam.halo;
+    if(*job.stamp != stamp){
+        *job.stamp = 0;
+        const bool useSat = !job.seam.on && (int)std::max(1.f, P.crestWidth) > kSatMinRadius;
+        if(useSat && st.satKey != st.recKey){
+            st.satKey = 0;
+            buildSat_(st.rec.data(), st.sat, job.W, job.Hs, forEach);
+            if(cancelled_(job)) return;
+            st.satKey = st.recKey;
+        }else if(!useSat){
+            std::vector<double>().swap(st.sat);
+            st.satKey = 0;
+        }
+        const int tx = (job.Wo + kTile - 1) / kTile, ty = (job.Ho + kTile - 1) / kTile;
+        forEach(tx*ty, [&](int t){
+            const int i0 = (t % tx) * kTile, i1 = std::min(job.Wo, i0 + kTile);
+            const int j0 = (t / tx) * kTile, j1 = std::min(job.Ho, j0 + kTile);
+            for(int j=j0;j<j1;j++)
+                std::memcpy(job.out + (size_t)j*job.ldo + i0, st.rec.data() + (size_t)(j+h)*job.W + i0 + h,
+                            (size_t)(i1-i0)*sizeof(float));
+            crestTile_(st.rec.data(), useSat ? st.sat.data() : nullptr, job.out, job.ldo, job.W, job.Hs, P,
+                       i0 + h, i1 + h, j0 + h, j1 + h, h);
+        });
+        if(st.rawStep == 1) aeolian_(job, P, forEach);
+        if(cancelled_(job)) return;
+        *job.stamp = stamp;
+        job.changed = true;
+    }
+}
+
+void TerrainGenerator::aeolian_(ChunkJob& job, const Params& P, const ForEach& forEach)
+{
+    // Derniere etape, sur la sortie : tirages propres au chunk (offset monde)
+    if(!Aeolian::active(P) || cancelled_(job)) return;
+    Fingerprint seed;
+    seed << job.ox << job.oy;
+    Aeolian::run(job.out, job.ldo, job.Wo, job.Ho,
+                 P.terrainWidth / (float)std::max(1, job.Wo - 1), P.terrainLength / (float)std::max(1, job.Ho - 1),
+                 P, seed.value(), forEach);
+}
+
+void TerrainGenerator::streamedChunk_(ChunkJob& job, const Params& P, const ForEach& forEach, int bands) const
+{
+    // tout sur place dans la sortie : pas de buffer de la taille du chunk
+    float minH, maxH;
+    job.raw = job.out;
+    job.ldr = job.ldo;
+    rawStage_(job, P, forEach, minH, maxH);
+    recenter_(job, P, forEach, job.out, job.ldo, job.out, job.ldo, minH, maxH, 1);
+    job.changed = true;
+    if(!crestActive(P)) return;
+
+    // Bandes de lignes traitees sur place : chaque bande garde d'abord une
+    // copie des r lignes voisines au-dessus et au-dessous (ecrites par les
+    // autres bandes), puis defile ses lignes.
+    const int W = job.W, Hs = job.Hs;
+    const int r = (int)std::max(1.f, P.crestWidth);
+    float* H = job.out;
+    const size_t ld = job.ldo;
+    auto bandRows = [&](int b, int& y0, int& y1){
+        y0 = (int)((long long)b * Hs / bands);
+        y1 = (int)((long long)(b+1) * Hs / bands);
+    };
+    std::vector<std::vector<float>> above(bands), below(bands);
+    forEach(bands, [&](int b){
+        int y0, y1;
+        bandRows(b, y0, y1);
+        const int ya = std::max(0, y0 - r), yb = std::min(Hs, y1 + r);
+        above[b].resize((size_t)(y0 - ya)*W);
+        below[b].resize((size_t)(yb - y1)*W);
+        for(int y=ya;y<y0;y++) std::memcpy(above[b].data() + (size_t)(y - ya)*W, H + (size_t)y*ld, (size_t)W*sizeof(float));
+        for(int y=y1;y<yb;y++) std::memcpy(below[b].data() + (size_t)(y - y1)*W, H + (size_t)y*ld, (size_t)W*sizeof(float));
+    });
+    forEach(bands, [&](int b){
+        int y0, y1;
+        bandRows(b, y0, y1);
+        crestStream_(H, ld, W, Hs, P, y0, y1, above[b].data(), below[b].data());
+    });
+}
+
+void TerrainGenerator::setupChunk_(ChunkNoise& cn, const Params& P,
+                                   double chunkWorldOffsetX, double chunkWorldOffsetY, bool preview,
+                                   const Seam& seam) const
+{
+    cn.preview = preview;
+    cn.seam = seam;
+    if(!P.largeWorld){
+        cn.main = preview
+            ? noise_->previewRowKernel(P.ridgedMode, P.noiseOctaves(), P.noiseLacunarity(), P.noiseGain())
+            : noise_->rowKernel(P.ridgedMode, P.noiseOctaves(), P.noiseLacunarity(), P.noiseGain());
+        cn.warpX = preview
+            ? noise_->previewRowKernel(false, 3, 2.0f, 0.5f)
+            : noise_->rowKernel(false, 3, 2.0f, 0.5f);
+        cn.warpY = cn.warpX;
+        cn.ox = (float)chunkWorldOffsetX; cn.oy = (float)chunkWorldOffsetY;
+        cn.offX = P.noiseOffsetX; cn.offY = P.noiseOffsetY;
+        cn.warpShift = 100.f;
+        return;
+    }
+
+    // Monde etendu : origine du chunk dans l'espace bruit, en double (meme
+    // transformation que rowCoords_), puis decoupee par octave par le moteur.
+    // Raccord : ancre commune a la grille, coordonnees relatives a elle.
+    if(seam.on){
+        chunkWorldOffsetX = seam.anchorX;
+        chunkWorldOffsetY = seam.anchorY;
+        cn.seam.anchorX = cn.seam.anchorY = 0.0;
+    }
+    float cosR, sinR;
+    rotationCS(P, cosR, sinR);
+    const double x0 = chunkWorldOffsetX * P.stretchX;
+    const double y0 = chunkWorldOffsetY * P.stretchY;
+    const double xo = x0*cosR - y0*sinR + P.noiseOffsetX;
+    const double yo = x0*sinR + y0*cosR + P.noiseOffsetY;
+    const double zf = (double)P.noiseZoom * (double)P.freq;
+    const double wf = P.warpFreq;
+
+    cn.main  = noise_->worldRowKernel(P.ridgedMode, P.noiseOctaves(), P.noiseLacunarity(), P.noiseGain(),
+                                      xo*zf, yo*zf, cn.wMain);
+    cn.warpX = noise_->worldRowKernel(false, 3, 2.0f, 0.5f, xo*wf, yo*wf, cn.wWarpX);
+    cn.warpY = noise_->worldRowKernel(false, 3, 2.0f, 0.5f, (xo+100)*wf, (yo+100)*wf, cn.wWarpY);
+    cn.ox = cn.oy = 0.f;
+    cn.offX = cn.offY = 0.f;
+    cn.warpShift = 0.f;
+}
 
-            float baseX = localBaseX + chunkWorldOffsetX;
-            float baseY = localBaseY + chunkWorldOffsetY;
+template<bool Warp, bool Grad>
+void TerrainGenerator::heightTile_(
+    float* out, size_t ldo, int W, int Hs, int i0, int i1, int j0, int j1, const Lattice& lat,
+    const Params& P, const ChunkNoise& cn, const WarpField* wf, float* grad, float& minH, float& maxH) const
+{
+    float cosR, sinR;
+    rotationCS(P, cosR, sinR);
+    const float zSign = P.invertZ ? -1.f : 1.f;
 
-            float x0 = baseX * P.stretchX;
-            float y0 = baseY * P.stretchY;
+    // Buffers d'une ligne de tuile : le bruit est evalue par lots (NoiseBackend::RowKernel)
+    const int N = i1 - i0;
+    std::vector<float> xr(N), yr(N), ax(N), ay(N), wx, wy, n(N);
+    // Champ d'apercu grossier : lignes du champ melangees (lx, ly), puis
+    // segments deplies a pleine resolution (ex, ey)
+    const bool coarse = Warp && !Grad && wf->step > 1; // step = kPreviewWarpStep
+    std::vector<float> lx, ly, ex, ey;
+    // Gradient : derivees du bruit (n, wx, wy) par rapport a leurs entrees
+    std::vector<float> nX, nY, dn, wxX, wxY, wyX, wyY;
+    if(Warp){ wx.resize(N); wy.resize(N); }
+    if(coarse){
+        const int s = kPreviewWarpStep;
+        lx.resize(N / s + 3); ly.resize(lx.size());
+        ex.resize(lx.size() * s); ey.resize(ex.size());
+    }
+    if(Grad){
+        nX.resize(N); nY.resize(N); dn.resize(N);
+        if(Warp){ wxX.resize(N); wxY.resize(N); wyX.resize(N); wyY.resize(N); }
+    }
 
-            float xr = x0*cosR - y0*sinR;
-            float yr = x0*sinR + y0*cosR;
+    // Chaine : (X,Y) monde -> (xr,yr) (etirement + rotation) -> (ax,ay)
+    const float xrX = P.stretchX*cosR, xrY = -P.stretchY*sinR;
+    const float yrX = P.stretchX*sinR, yrY =  P.stretchY*cosR;
+    const float zf = P.noiseZoom*P.freq;
+    const float kw = P.warpAmp*P.warpFreq;
+    const float zs = 0.25f * P.amp * zSign;
+    const RidgeShape ridge(P);
 
-            xr += P.noiseOffsetX;
-            yr += P.noiseOffsetY;
+    // un lot = colonnes c0, c0+dc, ... (dc = 1 hors raffinement progressif) ;
+    // x etire des colonnes garde tant que le lot ne change pas
+    std::vector<float> x0(N);
+    int xc0 = -1, xdc = 0, xcnt = 0;
+    forRuns_(lat, i0, i1, j0, j1, [&](int j, int c0, int dc, int cnt){
+        const size_t base = (size_t)j*(size_t)W + c0;
+        if(c0 != xc0 || dc != xdc || cnt != xcnt){
+            colCoords_(cn, c0, dc, cnt, W, P, x0.data());
+            xc0 = c0; xdc = dc; xcnt = cnt;
+        }
+        rowCoords_(cn, j, cnt, Hs, P, cosR, sinR, x0.data(), xr.data(), yr.data());
 
-            float wx=0.f, wy=0.f;
-            if(P.warpEnabled){
-                wx = noise_.fbm(xr*P.warpFreq,      yr*P.warpFreq,      3,2.0f,0.5f)*P.warpAmp;
-                wy = noise_.fbm((xr+100)*P.warpFreq,(yr+100)*P.warpFreq,3,2.0f,0.5f)*P.warpAmp;
+        if(Warp){
+            const float* rwx;
+            const float* rwy;
+            if(Grad){
+                for(int i=0;i<cnt;i++){ ax[i]=xr[i]*P.warpFreq; ay[i]=yr[i]*P.warpFreq; }
+                cn.warpX(ax.data(), ay.data(), wx.data(), wxX.data(), wxY.data(), cnt);
+                for(int i=0;i<cnt;i++){ ax[i]=(xr[i]+cn.warpShift)*P.warpFreq; ay[i]=(yr[i]+cn.warpShift)*P.warpFreq; }
+                cn.warpY(ax.data(), ay.data(), wy.data(), wyX.data(), wyY.data(), cnt);
+                rwx = wx.data(); rwy = wy.data();
+            }else if(coarse){
+                // bilineaire : ligne j entre les lignes r0 et r0+1 du champ,
+                // puis entre deux points du champ
+                constexpr int s = kPreviewWarpStep; // wf->step
+                const int r0 = j / s, k0 = c0 / s, k1 = (c0 + (cnt - 1)*dc) / s + 1;
+                const float fy = (float)(j - r0*s) * (1.f / s);
+                const float* fx0 = wf->wx.data() + (size_t)r0*wf->cw;
+                const float* fy0 = wf->wy.data() + (size_t)r0*wf->cw;
+                const float* fx1 = fx0 + wf->cw;
+                const float* fy1 = fy0 + wf->cw;
+                for(int k=k0;k<=k1;k++){
+                    lx[k-k0] = fx0[k] + (fx1[k] - fx0[k]) * fy;
+                    ly[k-k0] = fy0[k] + (fy1[k] - fy0[k]) * fy;
+                }
+                for(int k=0;k<k1-k0;k++){
+                    const float dx = (lx[k+1] - lx[k]) * (1.f / s), dy = (ly[k+1] - ly[k]) * (1.f / s);
+                    for(int q=0;q<s;q++){ ex[k*s+q] = lx[k] + dx * (float)q; ey[k*s+q] = ly[k] + dy * (float)q; }
+                }
+                rwx = ex.data() + (c0 - k0*s);
+                rwy = ey.data() + (c0 - k0*s);
+                if(dc != 1){
+                    for(int i=0;i<cnt;i++){ wx[i] = rwx[(size_t)i*dc]; wy[i] = rwy[(size_t)i*dc]; }
+                    rwx = wx.data(); rwy = wy.data();
+                }
+            }else if(dc == 1){
+                rwx = wf->wx.data() + base;
+                rwy = wf->wy.data() + base;
+            }else{
+                for(int i=0;i<cnt;i++){ wx[i] = wf->wx[base + (size_t)i*dc]; wy[i] = wf->wy[base + (size_t)i*dc]; }
+                rwx = wx.data(); rwy = wy.data();
             }
 
-            float nx=(xr+wx)*P.noiseZoom;
-            float ny=(yr+wy)*P.noiseZoom;
+            for(int i=0;i<cnt;i++){
+                float nx=(xr[i]+rwx[i]*P.warpAmp)*P.noiseZoom;
+                float ny=(yr[i]+rwy[i]*P.warpAmp)*P.noiseZoom;
+                ax[i]=nx*P.freq; ay[i]=ny*P.freq;
+            }
+        }else{
+            for(int i=0;i<cnt;i++){
+                float nx=xr[i]*P.noiseZoom;
+                float ny=yr[i]*P.noiseZoom;
+                ax[i]=nx*P.freq; ay[i]=ny*P.freq;
+            }
+        }
 
-            float n = P.ridgedMode
-                ? noise_.ridgedFBM(nx*P.freq, ny*P.freq, P.octaves, P.lacunarity, P.gain)
-                : noise_.fbm      (nx*P.freq, ny*P.freq, P.octaves, P.lacunarity, P.gain);
+        if(Grad) cn.main(ax.data(), ay.data(), n.data(), nX.data(), nY.data(), cnt);
+        else     cn.main(ax.data(), ay.data(), n.data(), cnt);
 
-            float z = (n * 0.25f) * P.amp;
-            if(P.invertZ) z *= -1.f;
+        // Cretes mises en forme sur le lot, avant gradient et stockage (pas
+        // de passe a part sur le chunk)
+        if(ridge.on){
+            ridge.apply(n.data(), cnt, cn.preview, Grad ? dn.data() : nullptr);
+            if(Grad) for(int i=0;i<cnt;i++){ nX[i] *= dn[i]; nY[i] *= dn[i]; }
+        }
 
-            out[(size_t)j*(size_t)W + (size_t)i] = z;
-            minH = std::min(minH, z);
-            maxH = std::max(maxH, z);
+        if(Grad){
+            for(int i=0;i<cnt;i++){
+                // dn/dxr, dn/dyr (jacobien du warp si actif)
+                float dxr = nX[i], dyr = nY[i];
+                if(Warp){
+                    dxr = nX[i]*(1.f + kw*wxX[i]) + nY[i]*(kw*wyX[i]);
+                    dyr = nX[i]*(kw*wxY[i]) + nY[i]*(1.f + kw*wyY[i]);
+                }
+                float* g = grad + (base + (size_t)i*dc)*2;
+                g[0] = (dxr*xrX + dyr*yrX) * zf * zs;
+                g[1] = (dxr*xrY + dyr*yrY) * zf * zs;
+            }
         }
+
+        // z = (n*0.25)*amp : *0.25 exact, meme arrondi que n*(0.25*amp)
+        float* row = out + (size_t)j*ldo + c0;
+        if(dc == 1) scaleMinMax(n.data(), cnt, 0.25f * P.amp, row, 1, minH, maxH);
+        else        scaleMinMax(n.data(), cnt, 0.25f * P.amp, row, (size_t)dc, minH, maxH);
+    });
+}
+
+bool TerrainGenerator::WarpKey::operator==(const WarpKey& o) const
+{
+    return W == o.W && Hs == o.Hs
+        && terrainWidth == o.terrainWidth && terrainLength == o.terrainLength
+        && offsetX == o.offsetX && offsetY == o.offsetY && largeWorld == o.largeWorld
+        && stretchX == o.stretchX && stretchY == o.stretchY && rotationDeg == o.rotationDeg
+        && noiseOffsetX == o.noiseOffsetX && noiseOffsetY == o.noiseOffsetY
+        && warpFreq == o.warpFreq && noiseGen == o.noiseGen
+        && halo == o.halo && anchorX == o.anchorX && anchorY == o.anchorY;
+}
+
+TerrainGenerator::WarpKey TerrainGenerator::warpKey_(
+    int W, int Hs, const Params& P, double chunkWorldOffsetX, double chunkWorldOffsetY, const Seam& seam) const
+{
+    WarpKey key;
+    key.W = W; key.Hs = Hs;
+    key.terrainWidth = P.terrainWidth; key.terrainLength = P.terrainLength;
+    key.offsetX = chunkWorldOffsetX; key.offsetY = chunkWorldOffsetY;
+    key.largeWorld = P.largeWorld;
+    key.stretchX = P.stretchX; key.stretchY = P.stretchY; key.rotationDeg = P.rotationDeg;
+    key.noiseOffsetX = P.noiseOffsetX; key.noiseOffsetY = P.noiseOffsetY;
+    key.warpFreq = P.warpFreq;
+    key.noiseGen = noiseGen_;
+    if(seam.on){ key.halo = seam.halo; key.anchorX = seam.anchorX; key.anchorY = seam.anchorY; }
+    return key;
+}
+
+std::shared_ptr<const TerrainGenerator::WarpField> TerrainGenerator::lookupWarp_(const WarpKey& key, bool preview) const
+{
+    std::lock_guard<std::mutex> lock(warpMu_);
+    auto it = warpCache_.find(std::make_pair(key.offsetX, key.offsetY));
+    // un champ pleine qualite sert aussi l'apercu, pas l'inverse
+    if(it != warpCache_.end() && it->second.field->key == key && (!it->second.field->preview || preview)){
+        it->second.lastUse = ++warpTick_;
+        return it->second.field;
     }
+    return nullptr;
+}
+
+void TerrainGenerator::fillWarpTile_(WarpField& f, const Params& P, const ChunkNoise& cn, const Lattice& lat,
+                                     int i0, int i1, int j0, int j1)
+{
+    const int W = f.key.W, Hs = f.key.Hs;
+    const int N = i1 - i0;
+    float cosR, sinR;
+    rotationCS(P, cosR, sinR);
+    std::vector<float> xr(N), yr(N), ax(N), ay(N), tx(N), ty(N);
+    forRuns_(lat, i0, i1, j0, j1, [&](int j, int c0, int dc, int cnt){
+        const size_t base = (size_t)j*(size_t)W + c0;
+        rowCoords_(cn, j, c0, dc, cnt, W, Hs, P, cosR, sinR, xr.data(), yr.data());
+        float* rwx = dc == 1 ? f.wx.data() + base : tx.data();
+        float* rwy = dc == 1 ? f.wy.data() + base : ty.data();
+        for(int i=0;i<cnt;i++){ ax[i]=xr[i]*P.warpFreq; ay[i]=yr[i]*P.warpFreq; }
+        cn.warpX(ax.data(), ay.data(), rwx, cnt);
+        for(int i=0;i<cnt;i++){ ax[i]=(xr[i]+cn.warpShift)*P.warpFreq; ay[i]=(yr[i]+cn.warpShift)*P.warpFreq; }
+        cn.warpY(ax.data(), ay.data(), rwy, cnt);
+        if(dc != 1) for(int i=0;i<cnt;i++){ f.wx[base + (size_t)i*dc] = tx[i]; f.wy[base + (size_t)i*dc] = ty[i]; }
+    });
+}
+
+void TerrainGenerator::storeWarp_(std::shared_ptr<const WarpField> f) const
+{
+    std::lock_guard<std::mutex> lock(warpMu_);
+    if(f->bytes() > warpBudget_) return; // trop gros (ou cache coupe) : pas stocke
+    const std::pair<double,double> slot(f->key.offsetX, f->key.offsetY);
+    WarpSlot& s = warpCache_[slot];
+    if(s.field) warpBytes_ -= s.field->bytes();
+    warpBytes_ += f->bytes();
+    s.field = std::move(f);
+    s.lastUse = ++warpTick_;
+    evictWarp_(slot);
+}
 
-    // recentrage vertical (par chunk)
-    float offset = -(minH+maxH)/4.f;
-    for(float& v : out) v += offset;
+void TerrainGenerator::fillPreviewWarp_(WarpField& f, const Params& P, const ChunkNoise& cn, const ForEach& forEach)
+{
+    const int s = f.step, cw = f.cw;
+    const int ch = (int)(f.wx.size() / (size_t)cw);
+    const int kRows = 16;
+    float cosR, sinR;
+    rotationCS(P, cosR, sinR);
+    forEach((ch + kRows - 1) / kRows, [&](int b){
+        std::vector<float> xr(cw), yr(cw), ax(cw), ay(cw);
+        for(int r=b*kRows; r<std::min(ch, (b+1)*kRows); r++){
+            // points hors du chunk (derniere ligne / colonne) : memes formules
+            rowCoords_(cn, r*s, 0, s, cw, f.key.W, f.key.Hs, P, cosR, sinR, xr.data(), yr.data());
+            for(int i=0;i<cw;i++){ ax[i]=xr[i]*P.warpFreq; ay[i]=yr[i]*P.warpFreq; }
+            cn.warpX(ax.data(), ay.data(), f.wx.data() + (size_t)r*cw, cw);
+            for(int i=0;i<cw;i++){ ax[i]=(xr[i]+cn.warpShift)*P.warpFreq; ay[i]=(yr[i]+cn.warpShift)*P.warpFreq; }
+            cn.warpY(ax.data(), ay.data(), f.wy.data() + (size_t)r*cw, cw);
+        }
+    });
+}
 
-    crestPostProcess(out, W, Hs, P);
+// warpMu_ tenu par l'appelant
+void TerrainGenerator::evictWarp_(const std::pair<double,double>& keep) const
+{
+    while(warpBytes_ > warpBudget_){
+        auto victim = warpCache_.end();
+        for(auto it = warpCache_.begin(); it != warpCache_.end(); ++it){
+            if(it->first == keep) continue;
+            if(victim == warpCache_.end() || it->second.lastUse < victim->second.lastUse) victim = it;
+        }
+        if(victim == warpCache_.end()) break;
+        warpBytes_ -= victim->second.field->bytes();
+        warpCache_.erase(victim);
+    }
 }
 
-void TerrainGenerator::crestPostProcess(std::vector<float>& H, int W, int Hs, const Params& P)
+void TerrainGenerator::setWarpCacheBudget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(warpMu_);
+    warpBudget_ = bytes;
+    if(bytes == 0){
+        warpCache_.clear();
+        warpBytes_ = 0;
+        return;
+    }
+    evictWarp_(std::pair<double,double>(NAN, NAN));
+}
+
+void TerrainGenerator::clearWarpCache()
+{
+    std::lock_guard<std::mutex> lock(warpMu_);
+    warpCache_.clear();
+    warpBytes_ = 0;
+}
+
+size_t TerrainGenerator::warpCacheBytes() const
+{
+    std::lock_guard<std::mutex> lock(warpMu_);
+    return warpBytes_;
+}
+
+bool TerrainGenerator::crestActive(const Params& P)
+{
+    return P.crestSmoothing > 0.001f || P.crestSharpen > 0.001f;
+}
+
+void TerrainGenerator::buildSat_(const float* copy, std::vector<double>& sat, int W, int Hs, const ForEach& forEach)
+{
+    const size_t S = (size_t)W + 1;
+    sat.resize(S*((size_t)Hs + 1));
+    std::fill(sat.begin(), sat.begin() + S, 0.0);
+
+    // sommes de lignes (bandes de kTile lignes), puis cumul vertical (bandes
+    // de kTile colonnes)
+    forEach((Hs + kTile - 1) / kTile, [&](int b){
+        for(int y=b*kTile; y<std::min(Hs, (b+1)*kTile); y++){
+            const float* r = copy + (size_t)y*W;
+            double* o = sat.data() + (size_t)(y+1)*S;
+            double acc = 0.0;
+            o[0] = 0.0;
+            for(int x=0;x<W;x++){ acc += r[x]; o[x+1] = acc; }
+        }
+    });
+    forEach((W + kTile) / kTile, [&](int b){
+        const int x0 = b*kTile, x1 = std::min(W + 1, (b+1)*kTile);
+        for(int y=1;y<=Hs;y++){
+            const double* p = sat.data() + (size_t)(y-1)*S;
+            double* o = sat.data() + (size_t)y*S;
+            for(int x=x0;x<x1;x++) o[x] += p[x];
+        }
+    });
+}
+
+void TerrainGenerator::crestTile_(const float* copy, const double* sat, float* H, size_t ldh, int W, int Hs,
+                                  const Params& P, int x0, int x1, int y0, int y1, int halo)
 {
     const float smooth = P.crestSmoothing;
     const float sharp  = P.crestSharpen;
     const float radius = std::max(1.f, P.crestWidth);
-
-    if(smooth <= 0.001f && sharp <= 0.001f) return;
+    const size_t S = (size_t)W + 1;
 
     auto idx = [&](int x,int y){ return y*W + x; };
-    std::vector<float> copy = H;
 
-    for(int y=1; y<Hs-1; ++y){
-        for(int x=1; x<W-1; ++x){
+    for(int y=std::max(1, y0); y<std::min(Hs-1, y1); ++y){
+        for(int x=std::max(1, x0); x<std::min(W-1, x1); ++x){
             float h  = copy[idx(x,y)];
             float n1 = copy[idx(x-1,y)];
             float n2 = copy[idx(x+1,y)];
@@ -116,15 +1394,17 @@ void TerrainGenerator::crestPostProcess(std::vector<float>& H, int W, int Hs, co
             bool isCrest = (h > maxN);
             if(!isCrest) continue;
 
-            float sum=0; int count=0;
+            // fenetre (2r+1)^2 rognee au chunk (taps hors bornes ignores)
             int r = (int)radius;
-            for(int dy=-r; dy<=r; dy++){
-                for(int dx=-r; dx<=r; dx++){
-                    if(x+dx < 0 || x+dx >= W) continue;
-                    if(y+dy < 0 || y+dy >= Hs) continue;
-                    sum += copy[idx(x+dx,y+dy)];
-                    count++;
-                }
+            const int xa = std::max(0, x-r), xb = std::min(W, x+r+1);
+            const int ya = std::max(0, y-r), yb = std::min(Hs, y+r+1);
+            const int count = (xb-xa)*(yb-ya);
+            float sum = 0.f;
+            if(sat){
+                sum = (float)(sat[yb*S + xb] - sat[ya*S + xb] - sat[yb*S + xa] + sat[ya*S + xa]);
+            }else{
+                for(int yy=ya; yy<yb; yy++)
+                    for(int xx=xa; xx<xb; xx++) sum += copy[idx(xx,yy)];
             }
             float localAvg = sum / (float)std::max(1, count);
 
@@ -137,9 +1417,88 @@ void TerrainGenerator::crestPostProcess(std::vector<float>& H, int W, int Hs, co
                 float sharpened = outH + (outH - localAvg) * sharp * 0.8f;
                 outH = sharpened;
             }
-            H[idx(x,y)] = outH;
+            H[(size_t)(y-halo)*ldh + (x-halo)] = outH;
+        }
+    }
+}
+
+void TerrainGenerator::crestStream_(float* H, size_t ldh, int W, int Hs, const Params& P, int y0, int y1,
+                                    const float* above, const float* below)
+{
+    const float smooth = P.crestSmoothing;
+    const float sharp  = P.crestSharpen;
+    const int r = (int)std::max(1.f, P.crestWidth);
+    const int R = 2*r + 1;
+    const bool running = r > kSatMinRadius;
+    const int ya = std::max(0, y0 - r);
+
+    // Anneau des lignes d'origine [y-r, y+r] ; la ligne y+r+1 remplace y-r.
+    // Grand rayon : sommes de colonnes glissantes (double) sur ces lignes,
+    // puis prefixe par ligne -> boite en O(1). Petit rayon : somme directe
+    // dans l'anneau (meme ordre que crestTile_).
+    std::vector<float> ring((size_t)R*W);
+    std::vector<double> col, pre;
+    if(running){ col.assign(W, 0.0); pre.resize((size_t)W + 1); }
+    auto slot = [&](int k){ return ring.data() + (size_t)(k % R)*W; };
+    auto load = [&](int k){
+        const float* src = k < y0 ? above + (size_t)(k - ya)*W
+                         : k >= y1 ? below + (size_t)(k - y1)*W
+                         : H + (size_t)k*ldh; // pas encore ecrite par cette bande
+        float* d = slot(k);
+        std::memcpy(d, src, (size_t)W*sizeof(float));
+        if(running) for(int x=0;x<W;x++) col[x] += d[x];
+    };
+    for(int k=ya; k<std::min(Hs, y0 + r + 1); k++) load(k);
+
+    for(int y=y0; y<y1; y++){
+        if(y >= 1 && y < Hs-1){
+            const float* c  = slot(y);
+            const float* up = slot(y-1);
+            const float* dn = slot(y+1);
+            const int ra = std::max(0, y-r), rb = std::min(Hs, y+r+1);
+            bool preReady = false;
+            for(int x=1; x<W-1; ++x){
+                float h = c[x];
+                float maxN = std::max(std::max(c[x-1],c[x+1]), std::max(up[x],dn[x]));
+                if(!(h > maxN)) continue;
+
+                const int xa = std::max(0, x-r), xb = std::min(W, x+r+1);
+                const int count = (xb-xa)*(rb-ra);
+                float sum = 0.f;
+                if(running){
+                    if(!preReady){
+                        pre[0] = 0.0;
+                        for(int i=0;i<W;i++) pre[i+1] = pre[i] + col[i];
+                        preReady = true;
+                    }
+                    sum = (float)(pre[xb] - pre[xa]);
+                }else{
+                    for(int yy=ra; yy<rb; yy++){
+                        const float* s = slot(yy);
+                        for(int xx=xa; xx<xb; xx++) sum += s[xx];
+                    }
+                }
+                float localAvg = sum / (float)std::max(1, count);
+
+                float outH = h;
+                if(smooth > 0.001f){
+                    float t = smooth * 0.5f;
+                    outH = outH*(1.f-t) + localAvg*t;
+                }
+                if(sharp > 0.001f){
+                    float sharpened = outH + (outH - localAvg) * sharp * 0.8f;
+                    outH = sharpened;
+                }
+                H[(size_t)y*ldh + x] = outH;
+            }
+        }
+        if(y + 1 == y1) break;
+        if(y - r >= 0 && running){
+            const float* old = slot(y - r);
+            for(int x=0;x<W;x++) col[x] -= old[x];
         }
+        if(y + r + 1 < Hs) load(y + r + 1);
     }
 }
 
-} // namespace dune
\ No newline at end of file
+} // namespace dune
@@ -1,28 +1,374 @@
 // src/TerrainGenerator.h
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 #include "Params.h"
 #include "ChunkGrid.h"
-#include "Noise.h"
+#include "NoiseBackend.h"
+#include "ThreadPool.h"
 
 namespace dune {
 
 class TerrainGenerator {
 public:
-    explicit TerrainGenerator(const Noise& noise);
+    explicit TerrainGenerator(const NoiseBackend& noise);
 
-    void generateChunkGrid(ChunkGrid& grid, int W, int H, const Params& P) const;
+    // Changement de moteur (Params::noiseEngine) : le backend doit survivre au generateur
+    void setNoise(const NoiseBackend& noise);
+    const NoiseBackend& noise() const { return *noise_; }
 
+    // Apercu interactif (slider en cours de drag) : noyaux previewRowKernel
+    void setPreview(bool on) { preview_ = on; }
+    bool preview() const { return preview_; }
+
+    // Cache du champ de warp par chunk : les 2 fbm de warp ne dependent que
+    // des parametres de warp, de l'offset du chunk, de l'etirement, de la
+    // rotation et des offsets de bruit ; ils sont gardes d'une mise a jour a
+    // l'autre (freq, amp, gain, crete... ne les invalident pas). Eviction LRU
+    // au-dela du budget (octets ; 0 = pas de cache).
+    void setWarpCacheBudget(size_t bytes);
+    void clearWarpCache();
+    size_t warpCacheBytes() const;
+
+    // Chunks et tuiles de 64x64 repartis (vol de travail) sur
+    // Params::threadCount threads (0 = tous les coeurs, 1 = serie) ; sortie
+    // identique au bit pres quel que soit le nombre de threads.
+    // Etapes gardees par chunk (bruit brut -> recentrage/invertZ -> cretes),
+    // chacune avec l'empreinte des Params qu'elle lit : seules les etapes en
+    // aval d'un champ modifie sont refaites. Etapes rangees par offset monde
+    // du chunk (LRU au-dela de Params::chunkCacheMB, hors chunks de l'appel) :
+    // un redimensionnement ou une fenetre deplacee (Params::chunkStreaming)
+    // reprend tous les chunks encore presents, deplaces dans le bloc de grid
+    // avec leur empreinte (grid.stamps). Retourne false si aucune hauteur
+    // n'a change.
+    // Params::seamless : bords identiques au bit pres entre voisins (voir
+    // Seam) ; min/max reduits sur toute la grille avant le recentrage.
+    // step > 1 (raffinement progressif, cache actif) : bruit calcule sur le
+    // reseau 1/step seulement, le reste interpole. Les points deja calcules a
+    // un pas multiple (appel precedent, memes Params) sont repris : la suite
+    // 8, 4, 2, 1 coute au total une generation complete, et le pas 1 donne
+    // exactement la sortie d'un appel direct.
+    // cancel (optionnel) : teste avant chaque tuile ; s'il est leve, les
+    // tuiles restantes sont sautees, grid est incomplet (a jeter) et seules
+    // les etapes terminees restent valides pour l'appel suivant.
+    // Params::aeolianEnabled : transport eolien en derniere etape (pas 1).
+    // P.mipLevels > 0 : pyramide de chaque chunk reecrit refaite a la suite,
+    // depuis les floats (avant P.quantizedStorage).
+    bool generateChunkGrid(ChunkGrid& grid, int W, int H, const Params& P, int step = 1,
+                           const std::atomic<bool>* cancel = nullptr) const;
+    // Sans cache (grandes grilles hors UI) : tout se fait sur place dans
+    // le bloc de grid, cretes en flux (anneau de 2r+1 lignes par bande), aucun
+    // buffer de la taille d'un chunk en plus.
+    void setStageCache(bool on);
+    bool stageCache() const { return stageCache_; }
+    void clearStageCache();
+    size_t stageCacheBytes() const;
+
+    // Hors memoire (grilles plus grandes que la RAM) : la grille
+    // chunkCols x chunkRows de P est produite par fenetres de chunks
+    // consecutifs (ordre ChunkGrid::index) tenant dans budgetBytes (au moins
+    // un chunk, cf. outOfCoreChunkBytes) ; chaque chunk est passe a
+    // sink(c, r, hauteurs W*H) puis son buffer sert a la fenetre suivante.
+    // Memes hauteurs que generateChunkGrid, au bit pres. Raccord : une
+    // premiere passe (bruit seul) reduit min/max sur toute la grille, la
+    // seconde refait le bruit fenetre par fenetre. Le cache de warp
+    // (setWarpCacheBudget) s'ajoute au budget. false si sink echoue.
+    using ChunkSink = std::function<bool(int c, int r, const std::vector<float>& heights)>;
+    bool generateOutOfCore(int W, int H, const Params& P, size_t budgetBytes, const ChunkSink& sink) const;
+    // Octets tenus par un chunk en vol (sortie, etapes du raccord, warp)
+    static size_t outOfCoreChunkBytes(int W, int H, const Params& P);
+
+    // Generation repartie (shards) : la grille est coupee en `shards` blocs
+    // de chunks consecutifs (ordre ChunkGrid::index, cf. shardRange) ;
+    // generateShard ne calcule que le bruit brut des chunks du bloc `shard`
+    // (bordure de raccord comprise, Wr x Hr), par fenetres comme
+    // generateOutOfCore, et le passe a sink avec son min/max. finishChunk
+    // termine ensuite un chunk (recentrage + cretes) depuis ce bruit, avec
+    // son propre min/max ou, en raccord, celui de toute la grille : memes
+    // hauteurs que generateChunkGrid avec le cache d'etapes. Deterministe :
+    // le bruit ne depend que de P et de (c, r).
+    using RawSink = std::function<bool(int c, int r, const std::vector<float>& raw, int Wr, int Hr,
+                                       float minH, float maxH)>;
+    bool generateShard(int W, int H, const Params& P, int shard, int shards, size_t budgetBytes,
+                       const RawSink& sink) const;
+    // raw (Wr x Hr, rendu tel quel) ; false si sa taille ne correspond pas
+    bool finishChunk(std::vector<float>& out, std::vector<float>& raw, int c, int r, int W, int H,
+                     const Params& P, float minH, float maxH) const;
+    // Chunks [first, last) du bloc `shard` sur nChunks
+    static void shardRange(int shard, int shards, int nChunks, int& first, int& last);
+    // Empreinte de tout ce qui fixe les hauteurs de la grille (taille,
+    // Params, moteur) : des shards a fusionner doivent avoir la meme
+    uint64_t gridKey(int W, int H, const Params& P) const;
+
+    // Sans cache d'etapes (sur place, comme setStageCache(false)), chunk
+    // isole (Params::seamless ignore). outGrad (optionnel) : gradient analytique entrelace (dz/dX, dz/dY) par
+    // pixel, en unites monde locales au chunk. Il decrit le champ brut, avant
+    // la passe des cretes (le recentrage vertical ne change pas le gradient).
+    // Offsets en double : utilises tels quels en monde etendu
+    // (Params::largeWorld), arrondis en float sinon.
     void generateHeights(
         std::vector<float>& out, int W, int Hs, const Params& P,
-        float chunkWorldOffsetX, float chunkWorldOffsetY) const;
+        double chunkWorldOffsetX, double chunkWorldOffsetY,
+        std::vector<float>* outGrad = nullptr) const;
 
 private:
-    const Noise& noise_;
+    const NoiseBackend* noise_;
+    bool preview_ = false;
+
+    // Raccord entre chunks (Params::seamless). Un echantillon partage par deux
+    // voisins a le meme index entier (en demi-pas) dans les deux : sa
+    // coordonnee monde, calculee en double depuis cet index et une ancre
+    // commune a la grille, est la meme au bit pres. Chaque chunk calcule en
+    // plus une bordure de `halo` echantillons (rayon des cretes) : la passe
+    // des cretes voit les vraies valeurs du voisin et traite aussi les bords.
+    struct Seam {
+        bool on = false;
+        int halo = 0;
+        double anchorX = 0, anchorY = 0; // origine monde commune
+        long long kx0 = 0, ky0 = 0;      // index du 1er echantillon du buffer etendu
+        double dx = 0, dy = 0;           // demi-pas monde
+    };
+
+    // Entrees exactes du champ de warp (warpAmp n'en fait pas partie : le
+    // champ stocke les fbm bruts)
+    struct WarpKey {
+        int W = 0, Hs = 0;
+        float terrainWidth = 0, terrainLength = 0;
+        double offsetX = 0, offsetY = 0;
+        bool largeWorld = false;
+        float stretchX = 0, stretchY = 0, rotationDeg = 0;
+        float noiseOffsetX = 0, noiseOffsetY = 0;
+        float warpFreq = 0;
+        uint32_t noiseGen = 0;
+        int halo = -1;                   // -1 : sans raccord
+        double anchorX = 0, anchorY = 0;
+        bool operator==(const WarpKey& o) const;
+    };
+    struct WarpField {
+        WarpKey key;
+        bool preview = false;       // calcule avec les noyaux d'apercu
+        // step > 1 (apercu hors raccord) : points aux colonnes et lignes
+        // multiples de step seulement, cw par ligne (un point au-dela du
+        // dernier bord), interpoles a la lecture
+        int step = 1, cw = 0;
+        std::vector<float> wx, wy;  // W*Hs chacun (cw*ch si step > 1)
+        size_t bytes() const { return (wx.size() + wy.size()) * sizeof(float); }
+    };
+    struct WarpSlot {
+        std::shared_ptr<const WarpField> field;
+        uint64_t lastUse = 0;
+    };
+
+    uint32_t noiseGen_ = 0;
+    size_t warpBudget_ = (size_t)256 << 20;
+    mutable std::mutex warpMu_;
+    mutable std::map<std::pair<double,double>, WarpSlot> warpCache_; // cle : offset du chunk
+    mutable size_t warpBytes_ = 0;
+    mutable uint64_t warpTick_ = 0;
+
+    // Noyaux + repere d'un chunk, choisis une fois par generateHeights. En
+    // monde etendu l'origine du chunk vit dans les WorldOrigin (double) et les
+    // coordonnees de ligne restent locales. Non copiable : les RowKernel
+    // pointent sur les WorldOrigin.
+    struct ChunkNoise {
+        NoiseBackend::RowKernel main, warpX, warpY;
+        WorldOrigin wMain, wWarpX, wWarpY;
+        float ox = 0.f, oy = 0.f;     // offset du chunk ajoute en float (0 en monde etendu)
+        float offX = 0.f, offY = 0.f; // Params::noiseOffset (0 en monde etendu)
+        float warpShift = 100.f;      // decalage du 2e fbm de warp (dans l'origine en monde etendu)
+        bool preview = false;
+        Seam seam;
+
+        ChunkNoise() = default;
+        ChunkNoise(const ChunkNoise&) = delete;
+        ChunkNoise& operator=(const ChunkNoise&) = delete;
+    };
+    void setupChunk_(ChunkNoise& cn, const Params& P, double chunkWorldOffsetX, double chunkWorldOffsetY,
+                     bool preview, const Seam& seam) const;
+    // Coordonnees bruit (etirement + rotation + offsets) des n colonnes c0,
+    // c0+dc, ... de la ligne j ; partage par heightTile_ et fillWarpTile_
+    // (memes arrondis).
+    static void rowCoords_(const ChunkNoise& cn, int j, int c0, int dc, int n, int W, int Hs, const Params& P,
+                           float cosR, float sinR, float* xr, float* yr);
+    // Les memes en deux temps : x etire des colonnes (colCoords_, commun a
+    // toutes les lignes d'une tuile), puis rotation ligne par ligne
+    static void colCoords_(const ChunkNoise& cn, int c0, int dc, int n, int W, const Params& P, float* x0);
+    static void rowCoords_(const ChunkNoise& cn, int j, int n, int Hs, const Params& P,
+                           float cosR, float sinR, const float* x0, float* xr, float* yr);
+
+    // Points calcules par une passe : lignes et colonnes multiples de step,
+    // sauf ceux du reseau `from` (passe precedente, 0 = aucune).
+    struct Lattice {
+        int step = 1, from = 0;
+    };
+    // fn(j, c0, dc, n) par lot de colonnes c0, c0+dc, ... de la tuile
+    static void forRuns_(const Lattice& lat, int i0, int i1, int j0, int j1,
+                         const std::function<void(int,int,int,int)>& fn);
+
+    WarpKey warpKey_(int W, int Hs, const Params& P, double chunkWorldOffsetX, double chunkWorldOffsetY,
+                     const Seam& seam) const;
+    std::shared_ptr<const WarpField> lookupWarp_(const WarpKey& key, bool preview) const;
+    void storeWarp_(std::shared_ptr<const WarpField> f) const;
+    static void fillWarpTile_(WarpField& f, const Params& P, const ChunkNoise& cn, const Lattice& lat,
+                              int i0, int i1, int j0, int j1);
+    void evictWarp_(const std::pair<double,double>& keep) const;
+
+    // Sorties intermediaires d'un chunk. Cle = empreinte des Params lus par
+    // l'etape et par celles en amont (0 = a refaire). La sortie elle-meme vit
+    // dans la grille (grid.stamps).
+    struct ChunkStages {
+        uint64_t rawKey = 0, recKey = 0;
+        std::vector<float> raw;          // bruit * amp, sans signe ni recentrage
+        int rawStep = 0;                 // pas du reseau calcule dans raw (seuls points valides)
+        float minH = 0.f, maxH = 0.f;    // de raw (points calcules)
+        std::shared_ptr<WarpField> warp; // champ de warp partiel tant que rawStep > 1
+        std::vector<float> rec;          // recentre (+ invertZ) : entree des cretes
+        std::vector<double> sat;         // table des sommes de rec, (W+1)*(Hs+1)
+        uint64_t satKey = 0;             // recKey de la table
+        uint64_t lastUse = 0;
+        size_t bytes() const;
+    };
+    bool stageCache_ = true;
+    mutable std::mutex stageMu_;
+    mutable std::map<std::pair<double,double>, ChunkStages> stages_; // cle : offset du chunk
+    mutable uint64_t stageTick_ = 0;
+    void evictStages_(size_t budget) const; // stageMu_ tenu ; garde les chunks de l'appel
+
+    // Un chunk en cours de generation, decoupe en tuiles kTile x kTile :
+    // etape bruit (warp + bruit) par tuile, puis recentrage et cretes par
+    // tuile une fois min/max connus.
+    static constexpr int kTile = 64;
+    // Pas du champ de warp d'apercu : warp lisse (3 octaves a warpFreq), 16x
+    // moins de points a calculer et a relire
+    static constexpr int kPreviewWarpStep = 4;
+    struct ChunkJob {
+        float* out = nullptr;                // Wo x Ho, lignes espacees de ldo floats
+        size_t ldo = 0;
+        int W = 0, Hs = 0;                   // buffers de bruit (bordure de raccord comprise)
+        int Wo = 0, Ho = 0;                  // sortie : W - 2*halo, Hs - 2*halo
+        Seam seam;
+        double ox = 0, oy = 0;
+        float* grad = nullptr;
+        ChunkStages* st = nullptr;           // nullptr : chunk en flux, sans cache
+        float* raw = nullptr;                // cible du bruit brut (st->raw ou out), lignes de ldr
+        size_t ldr = 0;
+        Lattice lat;
+        uint64_t rawKey = 0, recKey = 0, outKey = 0;
+        uint64_t* stamp = nullptr;           // grid.stamps du chunk (cache actif)
+        bool changed = false;                // sortie reecrite
+        const std::atomic<bool>* cancel = nullptr;
+        ChunkNoise cn;
+        std::shared_ptr<const WarpField> wf; // champ de warp lu par les tuiles
+        std::shared_ptr<WarpField> fresh;    // hors cache : rempli par les tuiles, publie ensuite
+        int tilesX = 1, tilesY = 1;
+        std::vector<float> tileMin, tileMax;
+    };
+    // Position (en chunks) de la colonne c / ligne r : grille centree sur
+    // worldOrigin, ou coordonnees entieres autour du chunk de la camera
+    // (streaming) ; ancre et bordure du raccord
+    struct GridLayout {
+        int cols = 1, rows = 1;
+        bool streaming = false;
+        double cx0 = 0.0, cy0 = 0.0;
+        float centerCols = 0.f, centerRows = 0.f;
+        double originX = 0.0, originY = 0.0; // ChunkGrid::originX/Y
+        double anchorCX = 0.0, anchorCY = 0.0;
+        int halo = 0;
+        double colPos(int c) const { return streaming ? cx0 + c : (double)(c - centerCols); }
+        double rowPos(int r) const { return streaming ? cy0 + r : (double)(r - centerRows); }
+    };
+    static GridLayout layout_(const Params& P);
+    // Taille, offset monde et raccord du chunk (c,r) de la grille
+    static void initJob_(ChunkJob& job, const GridLayout& L, int c, int r, int W, int H, const Params& P);
+    // forEach(n, fn) : fn(0..n-1) sur le pool (ou en serie)
+    using ForEach = std::function<void(int, const std::function<void(int)>&)>;
+    // Chunks [first, last) par fenetres de `win` : jobs prets (buffers de
+    // sortie `out` ; stages : etapes locales invalidees) passes a fn(jobs, i0)
+    bool windows_(const GridLayout& L, size_t first, size_t last, size_t win, int W, int H, const Params& P,
+                  bool stages, std::vector<std::vector<float>>& out,
+                  const std::function<bool(std::vector<std::unique_ptr<ChunkJob>>&, size_t)>& fn) const;
+    static bool cancelled_(const ChunkJob& job)
+    {
+        return job.cancel && job.cancel->load(std::memory_order_relaxed);
+    }
+    void stageKeys_(ChunkJob& job, const Params& P, uint64_t normKey) const;
+    void beginChunk_(ChunkJob& job, const Params& P) const;
+    static void tileRect_(const ChunkJob& job, int t, int& i0, int& i1, int& j0, int& j1);
+    // band : tuile etendue a toute la largeur du chunk (apercu)
+    void genTile_(ChunkJob& job, const Params& P, int t, bool band = false) const;
+    void rawStage_(ChunkJob& job, const Params& P, const ForEach& forEach, float& minH, float& maxH) const;
+    // Champ de warp d'apercu (step = kPreviewWarpStep) : tous ses points, par
+    // paquets de lignes, avant les tuiles (chacune lit les points voisins)
+    static void fillPreviewWarp_(WarpField& f, const Params& P, const ChunkNoise& cn, const ForEach& forEach);
+    static void recenter_(const ChunkJob& job, const Params& P, const ForEach& forEach,
+                          const float* src, size_t lds, float* dst, size_t ldd,
+                          float rawMin, float rawMax, int step);
+    // Chunk avec etapes : bruit (+ min/max), puis recentrage et cretes avec
+    // le min/max du chunk ou, en raccord, celui de toute la grille
+    void rawPhase_(ChunkJob& job, const Params& P, const ForEach& forEach) const;
+    void outPhase_(ChunkJob& job, const Params& P, const ForEach& forEach, float minH, float maxH) const;
+    void streamedChunk_(ChunkJob& job, const Params& P, const ForEach& forEach, int bands) const;
+    // Transport eolien (Params::aeolian*) sur la sortie finie du chunk
+    static void aeolian_(ChunkJob& job, const Params& P, const ForEach& forEach);
+    // Raccord par fenetres (hors memoire) : rawOnly = bruit seul, min/max
+    // cumules dans minH/maxH ; sinon sortie avec ce min/max de toute la grille
+    struct SeamPass {
+        bool rawOnly = false;
+        float minH = 1e30f, maxH = -1e30f;
+    };
+    void runChunks_(std::vector<std::unique_ptr<ChunkJob>>& jobs, const Params& P,
+                    const std::atomic<bool>* cancel = nullptr, SeamPass* pass = nullptr) const;
+
+    // Pool partage (recree si Params::threadCount change) ; nullptr = serie
+    std::shared_ptr<ThreadPool> threadPool_(const Params& P) const;
+    mutable std::mutex poolMu_;
+    mutable std::shared_ptr<ThreadPool> pool_;
+
+    // Boucle pixel specialisee (warp on/off, gradient on/off) sur les points
+    // de `lat` dans la tuile [i0,i1) x [j0,j1) ; les noyaux de bruit sont
+    // choisis une fois par chunk.
+    // Warp sans gradient : champ lu dans `wf` ; avec gradient, warp recalcule
+    // ligne a ligne (derivees non cachees). Hauteurs sans invertZ (applique
+    // au recentrage) ; le gradient, lui, en tient compte.
+    // Apercu (ChunkNoise::preview, jamais avec gradient) : meme chaine, seuls
+    // changent le noyau, la pow des cretes (approchee) et le champ de warp
+    // (grossier, step > 1, interpole a la lecture).
+    template<bool Warp, bool Grad>
+    void heightTile_(float* out, size_t ldo, int W, int Hs, int i0, int i1, int j0, int j1, const Lattice& lat,
+                     const Params& P, const ChunkNoise& cn,
+                     const WarpField* wf, float* grad, float& minH, float& maxH) const;
 
-    static void crestPostProcess(std::vector<float>& H, int W, int Hs, const Params& P);
+    static bool crestActive(const Params& P);
+    // Table des sommes (summed-area table) de `copy` : sat[y*(W+1)+x] = somme
+    // sur [0,x) x [0,y). Lignes puis colonnes, par tuile ; en double (la
+    // difference de 4 coins reste exacte a ~1e-8 pres sur 1024^2).
+    static void buildSat_(const float* copy, std::vector<double>& sat, int W, int Hs, const ForEach& forEach);
+    // Au-dela de ce rayon la moyenne locale vient de la table (O(1) par pixel,
+    // independant de crestWidth) ; en dessous la somme directe reste moins
+    // chere (les 4 coins de la table ratent le cache sur des cretes eparses).
+    static constexpr int kSatMinRadius = 8;
+    // Cretes sur la tuile [x0,x1) x [y0,y1) : lit `copy` (hauteurs recentrees)
+    // et sa table si `sat` (sinon somme directe), ecrit H (lignes de ldh
+    // floats) aux pixels de crete. halo > 0 : copy a une bordure de halo
+    // pixels, H est l'interieur seul.
+    static void crestTile_(const float* copy, const double* sat, float* H, size_t ldh, int W, int Hs,
+                           const Params& P, int x0, int x1, int y0, int y1, int halo = 0);
+    // Cretes sur place dans H (lignes de ldh floats), lignes [y0,y1) :
+    // `above`/`below` = copies denses des r lignes d'origine juste
+    // au-dessus/au-dessous de la bande (rognees au chunk). Memoire O(W*r) ;
+    // memes valeurs que crestTile_ (a l'arrondi du double pres au-dela de
+    // kSatMinRadius).
+    static void crestStream_(float* H, size_t ldh, int W, int Hs, const Params& P, int y0, int y1,
+                             const float* above, const float* below);
 };
 
 } // namespace dune
\ No newline at end of file
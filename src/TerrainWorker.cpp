@@ -0,0 +1,109 @@
+// src/TerrainWorker.cpp
+#include "TerrainWorker.h"
+
+#include <algorithm>
+
+#include "HeightmapIO.h"
+
+namespace dune {
+
+TerrainWorker::TerrainWorker()
+    : noise_(NoiseBackend::create(NoiseEngine::Perlin, 1337)), gen_(*noise_)
+{
+    thread_ = std::thread([this]{ loop_(); });
+}
+
+TerrainWorker::~TerrainWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        quit_ = true;
+        cancel_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+}
+
+void TerrainWorker::submit(const Request& req)
+{
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        pending_ = std::make_unique<Request>(req);
+        if(running_) cancel_ = true;
+    }
+    wake_.notify_all();
+}
+
+std::unique_ptr<TerrainWorker::Result> TerrainWorker::take()
+{
+    std::lock_guard<std::mutex> lock(mu_);
+    return std::move(ready_);
+}
+
+void TerrainWorker::recycle(std::unique_ptr<Result> r)
+{
+    std::lock_guard<std::mutex> lock(mu_);
+    if(!spare_) spare_ = std::move(r);
+}
+
+bool TerrainWorker::busy() const
+{
+    std::lock_guard<std::mutex> lock(mu_);
+    return pending_ || running_;
+}
+
+void TerrainWorker::wait()
+{
+    std::unique_lock<std::mutex> lock(mu_);
+    idle_.wait(lock, [&]{ return !pending_ && !running_; });
+}
+
+void TerrainWorker::syncNoise_(const Params& P)
+{
+    const NoiseEngine e = (NoiseEngine)P.noiseEngine;
+    if(noise_->engine() == e) return;
+    auto next = NoiseBackend::create(e, 1337);
+    gen_.setNoise(*next);
+    noise_ = std::move(next);
+}
+
+void TerrainWorker::loop_()
+{
+    std::unique_lock<std::mutex> lock(mu_);
+    for(;;){
+        wake_.wait(lock, [&]{ return quit_ || pending_; });
+        if(quit_) return;
+        const Request req = *pending_;
+        pending_.reset();
+        cancel_ = false; // leve seulement sous mu_ : pas de demande perdue
+        running_ = true;
+        std::unique_ptr<Result> res = std::move(spare_);
+        lock.unlock();
+
+        syncNoise_(req.P);
+        gen_.setPreview(req.preview);
+        // Paliers successifs, chacun publie des qu'il est pret ; une demande
+        // plus recente interrompt la suite
+        for(int step = std::max(1, req.step); ; step /= 2){
+            if(!res) res = std::make_unique<Result>();
+            gen_.generateChunkGrid(res->grid, req.W, req.H, req.P, step, &cancel_);
+            if(cancel_) break;
+            res->W = req.W; res->H = req.H;
+            res->step = step;
+            HeightmapIO::buildChunkAtlasRGBA8(res->grid, req.W, req.H, 2, res->rgba,
+                                              &res->minH, &res->maxH, &res->atlasW, &res->atlasH);
+            lock.lock();
+            std::swap(ready_, res); // grille non prise : redevient buffer de travail
+            if(!res) res = std::move(spare_);
+            lock.unlock();
+            if(step == 1 || cancel_) break;
+        }
+
+        lock.lock();
+        if(res && !spare_) spare_ = std::move(res);
+        running_ = false;
+        if(!pending_) idle_.notify_all();
+    }
+}
+
+} // namespace dune
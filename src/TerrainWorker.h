@@ -0,0 +1,76 @@
+// src/TerrainWorker.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Params.h"
+#include "ChunkGrid.h"
+#include "NoiseBackend.h"
+#include "TerrainGenerator.h"
+
+namespace dune {
+
+// Generation en arriere-plan pour le viewer. Un thread possede le generateur
+// (et son backend de bruit) et une seule demande en attente : la plus
+// recente gagne et annule celle en cours a la tuile pres. Chaque grille
+// terminee (avec l'atlas de l'apercu 2D) attend que le thread de rendu la
+// prenne ; d'ici la il affiche la precedente.
+class TerrainWorker {
+public:
+    struct Request {
+        Params P{};
+        int W = 0, H = 0;
+        int step = 1;        // premier palier (> 1 : raffinement jusqu'a 1)
+        bool preview = false;
+    };
+    struct Result {
+        ChunkGrid grid;
+        int W = 0, H = 0;
+        int step = 1;        // palier de cette grille (1 = definitive)
+        std::vector<unsigned char> rgba;
+        int atlasW = 0, atlasH = 0;
+        float minH = 0.f, maxH = 0.f;
+    };
+
+    TerrainWorker();
+    ~TerrainWorker();
+
+    TerrainWorker(const TerrainWorker&) = delete;
+    TerrainWorker& operator=(const TerrainWorker&) = delete;
+
+    // Remplace la demande en attente, annule celle en cours
+    void submit(const Request& req);
+    // Derniere grille terminee (nullptr si rien de neuf). Rendre ensuite
+    // l'ancienne par recycle() : ses buffers servent aux suivantes.
+    std::unique_ptr<Result> take();
+    void recycle(std::unique_ptr<Result> r);
+    // Demande en attente ou en cours (paliers restants compris)
+    bool busy() const;
+    // Attend la fin de tout le travail demande (exports)
+    void wait();
+
+private:
+    void loop_();
+    void syncNoise_(const Params& P);
+
+    std::unique_ptr<NoiseBackend> noise_;
+    TerrainGenerator gen_; // thread du worker seulement
+
+    mutable std::mutex mu_;
+    std::condition_variable wake_;  // nouvelle demande ou arret
+    std::condition_variable idle_;  // plus rien a faire
+    std::unique_ptr<Request> pending_;
+    bool running_ = false;
+    bool quit_ = false;
+    std::atomic<bool> cancel_{false};
+    std::unique_ptr<Result> ready_; // terminee, pas encore prise
+    std::unique_ptr<Result> spare_; // buffers rendus par recycle()
+    std::thread thread_;
+};
+
+} // namespace dune
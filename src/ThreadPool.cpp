@@ -0,0 +1,129 @@
+// src/ThreadPool.cpp
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace dune {
+
+namespace {
+// Worker courant : pool + index de sa deque (-1 hors pool)
+thread_local const void* t_pool = nullptr;
+thread_local int t_index = -1;
+}
+
+int ThreadPool::defaultThreadCount()
+{
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+ThreadPool::ThreadPool(int threads)
+{
+    const int n = threads > 0 ? threads : defaultThreadCount();
+    for(int i=0;i<n;i++) queues_.push_back(std::make_unique<Queue>()); // n-1 deques + injection
+    workers_.reserve((size_t)(n - 1));
+    for(int i=0;i<n-1;i++) workers_.emplace_back([this, i]{ workerLoop_(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMu_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for(std::thread& t : workers_) t.join();
+}
+
+void ThreadPool::spawn(TaskGroup& g, std::function<void()> fn)
+{
+    g.pending_.fetch_add(1, std::memory_order_relaxed);
+    const int self = (t_pool == this) ? t_index : -1;
+    Queue& q = *queues_[self >= 0 ? self : (int)workers_.size()];
+    {
+        std::lock_guard<std::mutex> lock(q.mu);
+        q.tasks.push_back(Task{ std::move(fn), &g });
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+    // passage par sleepMu_ : pas de reveil perdu entre le test et l'attente
+    { std::lock_guard<std::mutex> lock(sleepMu_); }
+    wake_.notify_one();
+}
+
+bool ThreadPool::pop_(Queue& q, bool back, Task& t)
+{
+    std::lock_guard<std::mutex> lock(q.mu);
+    if(q.tasks.empty()) return false;
+    if(back){ t = std::move(q.tasks.back());  q.tasks.pop_back(); }
+    else    { t = std::move(q.tasks.front()); q.tasks.pop_front(); }
+    return true;
+}
+
+void ThreadPool::run_(Task& t)
+{
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    t.fn();
+    // groupe termine : reveil des wait() endormis (g peut etre detruit
+    // des la decrementation, on ne le relit pas)
+    if(t.group->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1){
+        { std::lock_guard<std::mutex> lock(sleepMu_); }
+        wake_.notify_all();
+    }
+}
+
+bool ThreadPool::tryRunOne_(int self)
+{
+    Task t;
+    const int nq = (int)queues_.size();
+    if(queued_.load(std::memory_order_acquire) <= 0) return false;
+    // sa deque (LIFO : la tuile la plus recente est chaude en cache), puis
+    // l'injection, puis vol chez les autres en partant du voisin
+    if(self >= 0 && pop_(*queues_[self], true, t)){ run_(t); return true; }
+    if(pop_(*queues_[nq-1], false, t)){ run_(t); return true; }
+    const int start = self >= 0 ? self + 1 : 0;
+    for(int k=0;k<nq-1;k++){
+        const int v = (start + k) % (nq-1);
+        if(v != self && pop_(*queues_[v], false, t)){ run_(t); return true; }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop_(int index)
+{
+    t_pool = this;
+    t_index = index;
+    for(;;){
+        if(tryRunOne_(index)) continue;
+        std::unique_lock<std::mutex> lock(sleepMu_);
+        wake_.wait(lock, [&]{ return stop_ || queued_.load(std::memory_order_acquire) > 0; });
+        if(stop_) return;
+    }
+}
+
+void ThreadPool::wait(TaskGroup& g)
+{
+    const int self = (t_pool == this) ? t_index : -1;
+    while(g.pending_.load(std::memory_order_acquire) > 0){
+        if(tryRunOne_(self)) continue;
+        // taches restantes deja prises par d'autres threads : sommeil jusqu'a
+        // la fin du groupe ou une nouvelle tache (imbrication)
+        std::unique_lock<std::mutex> lock(sleepMu_);
+        wake_.wait(lock, [&]{
+            return g.pending_.load(std::memory_order_acquire) <= 0
+                || queued_.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+void ThreadPool::parallelFor(int n, const std::function<void(int)>& fn)
+{
+    if(n <= 0) return;
+    if(workers_.empty() || n == 1){
+        for(int i=0;i<n;i++) fn(i);
+        return;
+    }
+    TaskGroup g;
+    for(int i=0;i<n;i++) spawn(g, [&fn, i]{ fn(i); });
+    wait(g);
+}
+
+} // namespace dune
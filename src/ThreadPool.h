@@ -0,0 +1,78 @@
+// src/ThreadPool.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dune {
+
+// Pool a vol de travail pour TerrainGenerator : une deque par worker (le
+// proprietaire depile en LIFO, les voleurs prennent en FIFO par l'autre
+// bout), plus une file d'injection pour les threads exterieurs. Les taches
+// peuvent en creer d'autres (chunk -> tuiles) ; wait() execute des taches
+// en attendant, donc l'imbrication ne bloque pas le pool.
+class ThreadPool {
+public:
+    // Compteur de taches en cours ; wait() rend la main quand il tombe a 0
+    class TaskGroup {
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+    private:
+        friend class ThreadPool;
+        std::atomic<int> pending_{0};
+    };
+
+    // threads <= 0 : std::thread::hardware_concurrency()
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Nombre total de threads de calcul (appelant compris)
+    int size() const { return (int)workers_.size() + 1; }
+
+    void spawn(TaskGroup& g, std::function<void()> fn);
+    // Execute des taches (locales, injectees ou volees) jusqu'a ce que g soit
+    // vide ; dort (sans tourner) tant qu'il n'y a rien a prendre
+    void wait(TaskGroup& g);
+
+    // fn(i) pour i dans [0,n), ordre quelconque ; retourne quand tout est fait.
+    // Appelable depuis une tache.
+    void parallelFor(int n, const std::function<void(int)>& fn);
+
+    static int defaultThreadCount();
+
+private:
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup* group = nullptr;
+    };
+    struct Queue {
+        std::mutex mu;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop_(int index);
+    bool tryRunOne_(int self);
+    bool pop_(Queue& q, bool back, Task& t);
+    void run_(Task& t);
+
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<Queue>> queues_; // [0,workers) : deques ; [workers] : injection
+
+    std::mutex sleepMu_;
+    std::condition_variable wake_;
+    std::atomic<int> queued_{0};
+    bool stop_ = false;
+};
+
+} // namespace dune
@@ -14,11 +14,26 @@ namespace dune
 
         if (ImGui::CollapsingHeader("Bruit principal", ImGuiTreeNodeFlags_DefaultOpen))
         {
-            S.needUpdate |= ImGui::SliderInt("Octaves", &P.octaves, 1, 10);
+            S.needUpdate |= ImGui::Combo("Moteur", &P.noiseEngine, "Perlin\0OpenSimplex2\0Value\0");
+            // Mode ridged : octaves / lacunarity / gain remplaces par ceux des
+            // cretes, masques ici (valeurs gardees pour le retour en fbm)
+            const bool fbm = !P.ridgedMode;
+            if (fbm)
+                S.needUpdate |= ImGui::SliderInt("Octaves", &P.octaves, 1, 10);
+            else
+                ImGui::TextDisabled("Octaves / Lacunarity / Gain : réglages Ridge (Rugosité fine)");
             S.needUpdate |= ImGui::SliderFloat("Freq", &P.freq, 0.002f, 0.1f);
-            S.needUpdate |= ImGui::SliderFloat("Lacunarity", &P.lacunarity, 1.0f, 3.0f);
-            S.needUpdate |= ImGui::SliderFloat("Gain", &P.gain, 0.1f, 0.9f);
+            if (fbm)
+            {
+                S.needUpdate |= ImGui::SliderFloat("Lacunarity", &P.lacunarity, 1.0f, 3.0f);
+                S.needUpdate |= ImGui::SliderFloat("Gain", &P.gain, 0.1f, 0.9f);
+            }
             S.needUpdate |= ImGui::SliderFloat("Amplitude", &P.amp, 5.f, 500.f);
+
+            if (ImGui::Button("Bench moteurs"))
+                S.requestNoiseBench = true;
+            if (!S.noiseBenchReport.empty())
+                ImGui::TextWrapped("%s", S.noiseBenchReport.c_str());
         }
 
         if (ImGui::CollapsingHeader("Warp / Déformation"))
@@ -37,13 +52,16 @@ namespace dune
 
         if (ImGui::CollapsingHeader("Rugosité fine (Ridged)"))
         {
+            // Hors mode ridged les reglages de cretes ne changent rien : pas
+            // de regeneration
             S.needUpdate |= ImGui::Checkbox("Ridged Mode", &P.ridgedMode);
-            S.needUpdate |= ImGui::SliderInt("Ridge Octaves", &P.ridgeOctaves, 1, 6);
-            S.needUpdate |= ImGui::SliderFloat("Ridge Lacunarity", &P.ridgeLacunarity, 1.0f, 3.0f);
-            S.needUpdate |= ImGui::SliderFloat("Ridge Gain", &P.ridgeGain, 0.2f, 0.9f);
-            S.needUpdate |= ImGui::SliderFloat("Ridge Bias", &P.ridgeBias, 0.f, 0.5f);
-            S.needUpdate |= ImGui::SliderFloat("Ridge Pow", &P.ridgePow, 0.5f, 3.f);
-            S.needUpdate |= ImGui::SliderFloat("Ridge Atten", &P.ridgeAttenuation, 0.2f, 1.f);
+            const bool ridged = P.ridgedMode;
+            S.needUpdate |= ImGui::SliderInt("Ridge Octaves", &P.ridgeOctaves, 1, 6) && ridged;
+            S.needUpdate |= ImGui::SliderFloat("Ridge Lacunarity", &P.ridgeLacunarity, 1.0f, 3.0f) && ridged;
+            S.needUpdate |= ImGui::SliderFloat("Ridge Gain", &P.ridgeGain, 0.2f, 0.9f) && ridged;
+            S.needUpdate |= ImGui::SliderFloat("Ridge Bias", &P.ridgeBias, 0.f, 0.5f) && ridged;
+            S.needUpdate |= ImGui::SliderFloat("Ridge Pow", &P.ridgePow, 0.5f, 3.f) && ridged;
+            S.needUpdate |= ImGui::SliderFloat("Ridge Atten", &P.ridgeAttenuation, 0.2f, 1.f) && ridged;
         }
 
         if (ImGui::CollapsingHeader("Affinage des Crêtes", ImGuiTreeNodeFlags_DefaultOpen))
@@ -53,11 +71,30 @@ namespace dune
             S.needUpdate |= ImGui::SliderFloat("Crest Width", &P.crestWidth, 1.0f, 20.0f);
         }
 
+        if (ImGui::CollapsingHeader("Sable éolien (Werner)"))
+        {
+            S.needUpdate |= ImGui::Checkbox("Transport de sable", &P.aeolianEnabled);
+            S.needUpdate |= ImGui::SliderInt("Itérations", &P.aeolianIterations, 0, 1000);
+            S.needUpdate |= ImGui::SliderFloat("Plaque (hauteur)", &P.aeolianSlab, 0.05f, 5.0f);
+            S.needUpdate |= ImGui::SliderInt("Saut (cellules)", &P.aeolianHop, 1, 16);
+            S.needUpdate |= ImGui::SliderFloat("Dépôt sur sable", &P.aeolianDepositSand, 0.0f, 1.0f);
+            S.needUpdate |= ImGui::SliderFloat("Dépôt sur sol nu", &P.aeolianDepositBare, 0.0f, 1.0f);
+            S.needUpdate |= ImGui::SliderFloat("Sable mobile", &P.aeolianSandDepth, 0.0f, 50.0f);
+            S.needUpdate |= ImGui::SliderFloat("Angle de repos", &P.aeolianReposeDeg, 5.0f, 60.0f);
+            S.needUpdate |= ImGui::InputInt("Graine", &P.aeolianSeed);
+        }
+
         if (ImGui::CollapsingHeader("Exploration du bruit", ImGuiTreeNodeFlags_DefaultOpen))
         {
             S.needUpdate |= ImGui::SliderFloat("Offset X", &P.noiseOffsetX, -1000.f, 1000.f);
             S.needUpdate |= ImGui::SliderFloat("Offset Y", &P.noiseOffsetY, -1000.f, 1000.f);
             S.needUpdate |= ImGui::SliderFloat("Zoom Bruit", &P.noiseZoom, 0.1f, 5.0f);
+            S.needUpdate |= ImGui::Checkbox("Monde etendu (origines double)", &P.largeWorld);
+            if (P.largeWorld)
+            {
+                S.needUpdate |= ImGui::InputDouble("Origine X", &P.worldOriginX, 500.0, 50000.0, "%.3f");
+                S.needUpdate |= ImGui::InputDouble("Origine Y", &P.worldOriginY, 500.0, 50000.0, "%.3f");
+            }
         }
 
         if (ImGui::CollapsingHeader("Terrain (dimensions world)", ImGuiTreeNodeFlags_DefaultOpen))
@@ -75,6 +112,18 @@ namespace dune
                 S.needUpdate = true;
 
             ImGui::Text("Total chunks: %d", std::max(1, P.chunkCols) * std::max(1, P.chunkRows));
+            ImGui::SliderInt("Threads (0 = auto)", &P.threadCount, 0, 64);
+
+            S.needUpdate |= ImGui::Checkbox("Streaming autour de la camera (WASD)", &P.chunkStreaming);
+            if (P.chunkStreaming)
+            {
+                S.needUpdate |= ImGui::InputDouble("Camera X", &P.camWorldX, P.terrainWidth * 0.25, P.terrainWidth * 4.0, "%.1f");
+                S.needUpdate |= ImGui::InputDouble("Camera Y", &P.camWorldY, P.terrainLength * 0.25, P.terrainLength * 4.0, "%.1f");
+            }
+            ImGui::SliderInt("Cache chunks (Mo)", &P.chunkCacheMB, 0, 8192);
+            S.needUpdate |= ImGui::Checkbox("Raccord entre chunks (export UE)", &P.seamless);
+            S.needUpdate |= ImGui::Checkbox("Stockage 16 bits (grille seule)", &P.quantizedStorage);
+            S.needUpdate |= ImGui::SliderInt("Niveaux de pyramide (0 = aucune)", &P.mipLevels, 0, 16);
         }
 
         if (ImGui::CollapsingHeader("Rognage"))
@@ -115,6 +164,9 @@ namespace dune
         ImGui::Checkbox("Wireframe / Fill", &P.filled);
         S.needUpdate |= ImGui::Checkbox("Invert Z", &P.invertZ);
 
+        ImGui::Checkbox("Apercu rapide (drag)", &S.fastPreview);
+        ImGui::Checkbox("Raffinement progressif", &S.progressive);
+
         if (ImGui::Button("Regenerate"))
             S.needUpdate = true;
 
@@ -159,6 +211,8 @@ namespace dune
         if (!S.configStatus.empty())
             ImGui::TextWrapped("%s", S.configStatus.c_str());
 
+        S.interacting = S.fastPreview && ImGui::IsAnyItemActive();
+
         ImGui::End();
     }
 
@@ -193,6 +247,11 @@ namespace dune
             
         ImGui::SameLine();
         ImGui::Text("min %.2f  max %.2f", minH, maxH);
+        if (S.generating)
+        {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1.0f, 0.75f, 0.3f, 1.0f), "Generation...");
+        }
 
         ImGui::Text("Preview: atlas %dx%d chunks", std::max(1, P.chunkCols), std::max(1, P.chunkRows));
 
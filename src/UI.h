@@ -13,15 +13,29 @@ struct UiState {
     bool needUpdate = false;
     bool needRebuild = false;
 
+    // Apercu rapide : noyaux de bruit reduits tant qu'un widget est actif
+    // (drag de slider), passe pleine qualite au relachement.
+    bool fastPreview = true;
+    bool interacting = false;
+
+    // Raffinement progressif : 1/8, 1/4, 1/2 puis pleine resolution, chaque
+    // palier affiche des qu'il est pret ; un changement relance a 1/8.
+    bool progressive = true;
+
+    // Generation en arriere-plan en cours (indicateur, mis par l'App)
+    bool generating = false;
+
     bool requestExportPGM = false;
     bool requestExportPNG = false;
     bool requestExportAllChunksRAW16 = false;
+    bool requestNoiseBench = false;
 
     bool autoLoadConfigOnStart = true;
     bool autoSaveConfigOnExit  = true;
 
     std::string configStatus;
     std::string lastExportPath;
+    std::string noiseBenchReport;
 };
 
 class UI {
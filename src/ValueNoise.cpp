@@ -0,0 +1,103 @@
+// src/ValueNoise.cpp
+#include "ValueNoise.h"
+
+#include <cmath>
+
+namespace dune {
+
+// [-1,1] a partir des 24 bits hauts
+static inline float latticeValue(uint32_t seed, int32_t x, int32_t y)
+{
+    return (float)(latticeHash(seed, x, y) >> 8) * (2.f / 16777215.f) - 1.f;
+}
+
+float ValueNoise::value2(uint32_t seed, float x, float y)
+{
+    return value2W(seed, 0, 0, x, y);
+}
+
+float ValueNoise::value2W(uint32_t seed, int32_t cx, int32_t cy, float x, float y)
+{
+    const float fx = std::floor(x), fy = std::floor(y);
+    const int32_t X = cellAdd(cx, (int32_t)fx), Y = cellAdd(cy, (int32_t)fy);
+    const int32_t X1 = cellAdd(X, 1), Y1 = cellAdd(Y, 1);
+    const float tx = x - fx, ty = y - fy;
+    const float u = tx*tx*tx*(tx*(tx*6-15)+10);
+    const float v = ty*ty*ty*(ty*(ty*6-15)+10);
+
+    const float v00 = latticeValue(seed, X,  Y);
+    const float v10 = latticeValue(seed, X1, Y);
+    const float v01 = latticeValue(seed, X,  Y1);
+    const float v11 = latticeValue(seed, X1, Y1);
+
+    const float a = v00 + u*(v10-v00);
+    const float b = v01 + u*(v11-v01);
+    return a + v*(b-a);
+}
+
+float ValueNoise::value2D(uint32_t seed, float x, float y, float& dx, float& dy)
+{
+    return value2DW(seed, 0, 0, x, y, dx, dy);
+}
+
+float ValueNoise::value2DW(uint32_t seed, int32_t cx, int32_t cy, float x, float y, float& dx, float& dy)
+{
+    const float fx = std::floor(x), fy = std::floor(y);
+    const int32_t X = cellAdd(cx, (int32_t)fx), Y = cellAdd(cy, (int32_t)fy);
+    const int32_t X1 = cellAdd(X, 1), Y1 = cellAdd(Y, 1);
+    const float tx = x - fx, ty = y - fy;
+    const float u = tx*tx*tx*(tx*(tx*6-15)+10);
+    const float v = ty*ty*ty*(ty*(ty*6-15)+10);
+    const float du = 30.f*(tx*tx)*((tx-1)*(tx-1));
+    const float dv = 30.f*(ty*ty)*((ty-1)*(ty-1));
+
+    const float v00 = latticeValue(seed, X,  Y);
+    const float v10 = latticeValue(seed, X1, Y);
+    const float v01 = latticeValue(seed, X,  Y1);
+    const float v11 = latticeValue(seed, X1, Y1);
+
+    const float a = v00 + u*(v10-v00);
+    const float b = v01 + u*(v11-v01);
+    dx = du*((v10-v00) + v*((v11-v01)-(v10-v00)));
+    dy = dv*(b-a);
+    return a + v*(b-a);
+}
+
+float ValueNoise::sampleDCtx_(const void* ctx, float x, float y, float& dx, float& dy)
+{
+    return value2D(((const ValueNoise*)ctx)->seed_, x, y, dx, dy);
+}
+
+float ValueNoise::sampleCtx_(const void* ctx, float x, float y)
+{
+    return value2(((const ValueNoise*)ctx)->seed_, x, y);
+}
+
+float ValueNoise::sampleWCtx_(const void* ctx, int32_t cx, int32_t cy, float x, float y)
+{
+    return value2W(*(const uint32_t*)ctx, cx, cy, x, y);
+}
+
+float ValueNoise::sampleDWCtx_(const void* ctx, int32_t cx, int32_t cy, float x, float y, float& dx, float& dy)
+{
+    return value2DW(*(const uint32_t*)ctx, cx, cy, x, y, dx, dy);
+}
+
+NoiseBackend::RowKernel ValueNoise::worldRowKernel(bool ridged, int oct, float lac, float gain,
+                                                   double originX, double originY, WorldOrigin& w) const
+{
+    return genericWorldKernel<&ValueNoise::sampleWCtx_, &ValueNoise::sampleDWCtx_>(
+        *this, &seed_, ridged, oct, lac, gain, originX, originY, w);
+}
+
+NoiseBackend::RowKernel ValueNoise::rowKernel(bool ridged, int oct, float lac, float gain) const
+{
+    RowKernel k;
+    k.fn = genericRowKernel<&ValueNoise::sampleCtx_>(ridged, oct);
+    k.fnD = genericRowKernelD<&ValueNoise::sampleDCtx_>(ridged);
+    k.ctx = this;
+    k.oct = oct; k.lac = lac; k.gain = gain;
+    return k;
+}
+
+} // namespace dune
@@ -0,0 +1,37 @@
+// src/ValueNoise.h
+#pragma once
+
+#include "NoiseBackend.h"
+
+namespace dune {
+
+// Bruit de valeur : une valeur pseudo-aleatoire par noeud du reseau (hash
+// entier 32 bits, pas de table), interpolee en quintique. Le moins cher des
+// moteurs, mais plus "carre" que Perlin / OpenSimplex2.
+class ValueNoise : public NoiseBackend {
+public:
+    NoiseEngine engine() const override { return NoiseEngine::Value; }
+    void init(uint32_t seed = 1337) override { seed_ = seed; }
+    uint32_t seed() const override { return seed_; }
+
+    float sample(float x, float y) const override { return value2(seed_, x, y); }
+    float sampleD(float x, float y, float& dx, float& dy) const override { return value2D(seed_, x, y, dx, dy); }
+    RowKernel rowKernel(bool ridged, int oct, float lac, float gain) const override;
+    RowKernel worldRowKernel(bool ridged, int oct, float lac, float gain,
+                             double originX, double originY, WorldOrigin& w) const override;
+
+private:
+    uint32_t seed_ = 1337;
+
+    static float value2(uint32_t seed, float x, float y);
+    static float value2D(uint32_t seed, float x, float y, float& dx, float& dy);
+    // (cx,cy) : cellule d'origine (monde etendu)
+    static float value2W(uint32_t seed, int32_t cx, int32_t cy, float x, float y);
+    static float value2DW(uint32_t seed, int32_t cx, int32_t cy, float x, float y, float& dx, float& dy);
+    static float sampleCtx_(const void* ctx, float x, float y);
+    static float sampleDCtx_(const void* ctx, float x, float y, float& dx, float& dy);
+    static float sampleWCtx_(const void* ctx, int32_t cx, int32_t cy, float x, float y);
+    static float sampleDWCtx_(const void* ctx, int32_t cx, int32_t cy, float x, float y, float& dx, float& dy);
+};
+
+} // namespace dune
@@ -0,0 +1,409 @@
+// src/cli_main.cpp
+// dune_cli : generation + export par lots, sans SDL ni contexte GL.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "Aeolian.h"
+#include "ChunkGrid.h"
+#include "ConfigKV.h"
+#include "HeightmapIO.h"
+#include "NoiseBackend.h"
+#include "Params.h"
+#include "ShardManifest.h"
+#include "TerrainGenerator.h"
+#include "ThreadPool.h"
+
+using namespace dune;
+
+namespace {
+
+struct CliOptions {
+    std::string config;            // vide : Params par defaut
+    int W = 0, H = 0;              // 0 : gridW/gridH de la config
+    int cols = 0, rows = 0;        // 0 : chunkCols/chunkRows de la config
+    int threads = -1;              // -1 : threadCount de la config
+    std::string format = "r16";    // r16 | r32 | png | pgm
+    std::string out = "heightmap_chunks";
+    bool seamless = false;
+    bool bench = false;            // generation seule, pas d'export
+    bool hugePages = false;        // grille en pages de 2 Mo (Linux)
+    bool quantize = false;         // grille stockee en 16 bits
+    int mip = 0;                   // > 0 : export du niveau de pyramide (moyennes)
+    int aeolian = -1;              // >= 0 : transport eolien, N iterations (0 : coupe)
+    int runs = 1;
+    int memBudgetMB = 0;           // > 0 : hors memoire, fenetres de chunks sous ce budget
+    int shard = -1, shards = 0;    // --shard I/N : bruit brut du bloc I + manifeste
+    int merge = 0;                 // --merge N : fusion des N manifestes
+};
+
+void usage(const char* argv0)
+{
+    std::printf(
+        "usage: %s [options]\n"
+        "  --config FICHIER   Params (format dune_last_config.cfg)\n"
+        "  --size WxH         sommets par chunk (defaut : config)\n"
+        "  --chunks CxR       grille de chunks (defaut : config)\n"
+        "  --threads N        0 = tous les coeurs (defaut : config)\n"
+        "  --format r16|r32|png|pgm  (defaut r16 ; r32 = float32 brut)\n"
+        "  --out PREFIXE      fichiers PREFIXE_rR_cC.ext (defaut heightmap_chunks)\n"
+        "  --seamless         bords identiques entre chunks voisins\n"
+        "  --bench            generation seule, chronometree (pas d'export)\n"
+        "  --runs N           nombre de generations (defaut 1)\n"
+        "  --huge-pages       grille en memoire sur pages de 2 Mo (Linux)\n"
+        "  --quantize         grille stockee en 16 bits par chunk (moitie de sa memoire)\n"
+        "  --aeolian N        transport de sable (Werner), N iterations ; avec\n"
+        "                     --bench : iterations/s sur un chunk\n"
+        "  --mip L            exporte le niveau L de la pyramide (moyennes,\n"
+        "                     chunks reduits de 2^L) au lieu des hauteurs\n"
+        "  --mem-budget MO    hors memoire : chunks generes par fenetres sous ce\n"
+        "                     budget et ecrits au fil de l'eau (monde > RAM)\n"
+        "  --shard I/N        bloc I (0..N-1) de la grille : bruit brut\n"
+        "                     PREFIXE_rR_cC.noise.r32 + PREFIXE_shardI_of_N.manifest\n"
+        "  --merge N          fusion des N manifestes : normalisation globale et\n"
+        "                     tuiles finales (memes options que les shards)\n",
+        argv0);
+}
+
+bool parsePair(const char* s, int& a, int& b)
+{
+    char* end = nullptr;
+    long x = std::strtol(s, &end, 10);
+    if(end == s || (*end != 'x' && *end != 'X')) return false;
+    const char* s2 = end + 1;
+    long y = std::strtol(s2, &end, 10);
+    if(end == s2 || *end != '\0' || x <= 0 || y <= 0) return false;
+    a = (int)x; b = (int)y;
+    return true;
+}
+
+bool parseShard(const char* s, int& i, int& n)
+{
+    char* end = nullptr;
+    long a = std::strtol(s, &end, 10);
+    if(end == s || *end != '/') return false;
+    const char* s2 = end + 1;
+    long b = std::strtol(s2, &end, 10);
+    if(end == s2 || *end != '\0' || b < 1 || a < 0 || a >= b) return false;
+    i = (int)a; n = (int)b;
+    return true;
+}
+
+bool parseInt(const char* s, int& v)
+{
+    char* end = nullptr;
+    long x = std::strtol(s, &end, 10);
+    if(end == s || *end != '\0') return false;
+    v = (int)x;
+    return true;
+}
+
+// 0 : ok, 1 : --help, 2 : erreur d'usage
+int parseArgs(int argc, char** argv, CliOptions& o)
+{
+    for(int i=1;i<argc;i++){
+        const char* a = argv[i];
+        const bool hasVal = i + 1 < argc;
+        if(!std::strcmp(a, "--help") || !std::strcmp(a, "-h")) return 1;
+        else if(!std::strcmp(a, "--seamless")) o.seamless = true;
+        else if(!std::strcmp(a, "--bench")) o.bench = true;
+        else if(!std::strcmp(a, "--huge-pages")) o.hugePages = true;
+        else if(!std::strcmp(a, "--quantize")) o.quantize = true;
+        else if(!hasVal){
+            std::fprintf(stderr, "option inconnue ou sans valeur : %s\n", a);
+            return 2;
+        }
+        else if(!std::strcmp(a, "--config")) o.config = argv[++i];
+        else if(!std::strcmp(a, "--out")) o.out = argv[++i];
+        else if(!std::strcmp(a, "--format")) o.format = argv[++i];
+        else if(!std::strcmp(a, "--size")){
+            if(!parsePair(argv[++i], o.W, o.H)){ std::fprintf(stderr, "--size attend WxH\n"); return 2; }
+        }
+        else if(!std::strcmp(a, "--chunks")){
+            if(!parsePair(argv[++i], o.cols, o.rows)){ std::fprintf(stderr, "--chunks attend CxR\n"); return 2; }
+        }
+        else if(!std::strcmp(a, "--threads")){
+            if(!parseInt(argv[++i], o.threads) || o.threads < 0){ std::fprintf(stderr, "--threads attend N >= 0\n"); return 2; }
+        }
+        else if(!std::strcmp(a, "--mem-budget")){
+            if(!parseInt(argv[++i], o.memBudgetMB) || o.memBudgetMB < 1){ std::fprintf(stderr, "--mem-budget attend MO >= 1\n"); return 2; }
+        }
+        else if(!std::strcmp(a, "--shard")){
+            if(!parseShard(argv[++i], o.shard, o.shards)){ std::fprintf(stderr, "--shard attend I/N, 0 <= I < N\n"); return 2; }
+        }
+        else if(!std::strcmp(a, "--merge")){
+            if(!parseInt(argv[++i], o.merge) || o.merge < 1){ std::fprintf(stderr, "--merge attend N >= 1\n"); return 2; }
+        }
+        else if(!std::strcmp(a, "--aeolian")){
+            if(!parseInt(argv[++i], o.aeolian) || o.aeolian < 0){ std::fprintf(stderr, "--aeolian attend N >= 0\n"); return 2; }
+        }
+        else if(!std::strcmp(a, "--mip")){
+            if(!parseInt(argv[++i], o.mip) || o.mip < 1 || o.mip > 16){ std::fprintf(stderr, "--mip attend L, 1 <= L <= 16\n"); return 2; }
+        }
+        else if(!std::strcmp(a, "--runs")){
+            if(!parseInt(argv[++i], o.runs) || o.runs < 1){ std::fprintf(stderr, "--runs attend N >= 1\n"); return 2; }
+        }
+        else {
+            std::fprintf(stderr, "option inconnue : %s\n", a);
+            return 2;
+        }
+    }
+    if(o.format != "r16" && o.format != "r32" && o.format != "png" && o.format != "pgm"){
+        std::fprintf(stderr, "--format : r16, r32, png ou pgm\n");
+        return 2;
+    }
+    if(o.shards > 0 && o.merge > 0){
+        std::fprintf(stderr, "--shard et --merge sont exclusifs\n");
+        return 2;
+    }
+    if(o.mip > 0 && (o.memBudgetMB > 0 || o.shards > 0 || o.merge > 0)){
+        std::fprintf(stderr, "--mip : grille en memoire seulement\n");
+        return 2;
+    }
+    return 0;
+}
+
+// Shard : bruit brut des chunks du bloc, ecrit au fil de l'eau (fenetres
+// sous --mem-budget, 1 Go par defaut), puis le manifeste
+int runShard(const CliOptions& o, const TerrainGenerator& gen, const Params& P, int W, int H)
+{
+    ShardManifest m;
+    m.shard = o.shard; m.shards = o.shards;
+    m.cols = P.chunkCols; m.rows = P.chunkRows;
+    m.W = W; m.H = H;
+    m.seamless = P.seamless;
+    m.gridKey = gen.gridKey(W, H, P);
+
+    int first, last;
+    TerrainGenerator::shardRange(o.shard, o.shards, P.chunkCols * P.chunkRows, first, last);
+    std::printf("shard %d/%d : chunks %d a %d\n", o.shard, o.shards, first, last - 1);
+
+    const size_t budget = (size_t)(o.memBudgetMB > 0 ? o.memBudgetMB : 1024) << 20;
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool ok = gen.generateShard(W, H, P, o.shard, o.shards, budget,
+        [&](int c, int r, const std::vector<float>& raw, int Wr, int Hr, float minH, float maxH){
+            ShardManifest::Chunk k;
+            k.c = c; k.r = r;
+            k.minH = minH; k.maxH = maxH;
+            k.checksum = ShardManifest::checksum(raw);
+            k.file = o.out + "_r" + std::to_string(r) + "_c" + std::to_string(c) + ".noise.r32";
+            if(!HeightmapIO::exportRAW32F(raw, Wr, Hr, k.file)){
+                std::fprintf(stderr, "ecriture impossible : %s\n", k.file.c_str());
+                return false;
+            }
+            m.rawW = Wr; m.rawH = Hr;
+            m.minH = std::min(m.minH, minH);
+            m.maxH = std::max(m.maxH, maxH);
+            m.chunks.push_back(k);
+            return true;
+        });
+    if(!ok) return 1;
+
+    const std::string path = ShardManifest::path(o.out, o.shard, o.shards);
+    if(!ShardManifest::save(m, path)){
+        std::fprintf(stderr, "ecriture impossible : %s\n", path.c_str());
+        return 1;
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("%s : %zu chunk(s) (%.1f ms)\n", path.c_str(), m.chunks.size(), ms);
+    return 0;
+}
+
+// Fusion : verifie que les N manifestes couvrent la grille une fois et
+// viennent des memes Params, puis termine chaque chunk (recentrage + cretes)
+// avec le min/max global (raccord) ou le sien. Un chunk en memoire a la fois.
+template<class WriteChunk>
+int runMerge(const CliOptions& o, const TerrainGenerator& gen, const Params& P, int W, int H,
+             const WriteChunk& writeChunk)
+{
+    const int total = P.chunkCols * P.chunkRows;
+    const uint64_t key = gen.gridKey(W, H, P);
+    std::vector<ShardManifest::Chunk> chunks(total);
+    std::vector<char> seen(total, 0);
+    float minH = 1e30f, maxH = -1e30f;
+    int rawW = 0, rawH = 0;
+    for(int i=0;i<o.merge;i++){
+        const std::string path = ShardManifest::path(o.out, i, o.merge);
+        ShardManifest m;
+        if(!ShardManifest::load(m, path)){
+            std::fprintf(stderr, "manifeste illisible : %s\n", path.c_str());
+            return 1;
+        }
+        if(m.gridKey != key || m.shards != o.merge || m.cols != P.chunkCols || m.rows != P.chunkRows
+           || m.W != W || m.H != H){
+            std::fprintf(stderr, "%s : autre grille ou autres Params que cette fusion\n", path.c_str());
+            return 1;
+        }
+        for(const ShardManifest::Chunk& k : m.chunks){
+            const int idx = ChunkGrid::index(k.c, k.r, P.chunkCols);
+            if(k.c < 0 || k.c >= P.chunkCols || k.r < 0 || k.r >= P.chunkRows || seen[idx]){
+                std::fprintf(stderr, "%s : chunk r%d c%d hors grille ou en double\n", path.c_str(), k.r, k.c);
+                return 1;
+            }
+            seen[idx] = 1;
+            chunks[idx] = k;
+        }
+        if(!m.chunks.empty()){ rawW = m.rawW; rawH = m.rawH; }
+        minH = std::min(minH, m.minH);
+        maxH = std::max(maxH, m.maxH);
+    }
+    for(int idx=0;idx<total;idx++){
+        if(!seen[idx]){
+            std::fprintf(stderr, "chunk r%d c%d absent des manifestes\n", idx / P.chunkCols, idx % P.chunkCols);
+            return 1;
+        }
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<float> raw, h;
+    for(int idx=0;idx<total;idx++){
+        const ShardManifest::Chunk& k = chunks[idx];
+        if(!HeightmapIO::importRAW32F(raw, rawW, rawH, k.file) || ShardManifest::checksum(raw) != k.checksum){
+            std::fprintf(stderr, "bruit brut illisible ou corrompu : %s\n", k.file.c_str());
+            return 1;
+        }
+        const float lo = P.seamless ? minH : k.minH;
+        const float hi = P.seamless ? maxH : k.maxH;
+        if(!gen.finishChunk(h, raw, k.c, k.r, W, H, P, lo, hi) || !writeChunk(k.c, k.r, h)){
+            std::fprintf(stderr, "fusion impossible : chunk r%d c%d\n", k.r, k.c);
+            return 1;
+        }
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("Fusion %d shard(s), export %s chunks: %d/%d (%.1f ms)\n",
+                o.merge, o.format.c_str(), total, total, ms);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    CliOptions o;
+    const int pr = parseArgs(argc, argv, o);
+    if(pr){ usage(argv[0]); return pr == 1 ? 0 : 2; }
+
+    Params P;
+    if(!o.config.empty() && !ConfigKV::load(P, o.config)){
+        std::fprintf(stderr, "config illisible : %s\n", o.config.c_str());
+        return 2;
+    }
+    if(o.W > 0){ P.gridW = o.W; P.gridH = o.H; }
+    if(o.cols > 0){ P.chunkCols = o.cols; P.chunkRows = o.rows; }
+    if(o.threads >= 0) P.threadCount = o.threads;
+    if(o.seamless) P.seamless = true;
+    if(o.quantize) P.quantizedStorage = true;
+    if(o.mip > 0) P.mipLevels = std::max(P.mipLevels, o.mip);
+    if(o.aeolian >= 0){ P.aeolianEnabled = o.aeolian > 0; P.aeolianIterations = o.aeolian; }
+    P.clampSafety();
+
+    // Meme moteur et graine que le viewer (TerrainWorker)
+    auto noise = NoiseBackend::create((NoiseEngine)P.noiseEngine, 1337);
+    TerrainGenerator gen(*noise);
+    // Une seule generation par grille : pas de cache d'etapes, tout sur place
+    gen.setStageCache(false);
+
+    const int W = P.gridW, H = P.gridH;
+    const double mpx = (double)W * H * P.chunkCols * P.chunkRows * 1e-6;
+    std::printf("dune_cli : %d x %d chunks de %dx%d (%.1f Mpx), threads %d%s\n",
+                P.chunkCols, P.chunkRows, W, H, mpx, P.threadCount,
+                P.seamless ? ", raccord" : "");
+
+    // Un fichier par chunk : PREFIXE_rR_cC.ext
+    auto writeView = [&](int c, int r, const ConstChunkView& h){
+        const std::string name = o.out + "_r" + std::to_string(r) + "_c" + std::to_string(c) + "." + o.format;
+        if(o.format == "png") return HeightmapIO::exportPNG(h, name);
+        if(o.format == "pgm") return HeightmapIO::exportPGM(h, name);
+        if(o.format == "r32") return HeightmapIO::exportRAW32F(h, name);
+        return HeightmapIO::exportRAW16(h, name, P.render_intensity,
+                                        P.render_maxHeightMeters, P.render_unrealHalfRange);
+    };
+    auto writeChunk = [&](int c, int r, const std::vector<float>& h){ return writeView(c, r, viewOf(h, W, H)); };
+    const int total = P.chunkCols * P.chunkRows;
+
+    if(o.shards > 0){
+        gen.setWarpCacheBudget(0);
+        return runShard(o, gen, P, W, H);
+    }
+    if(o.merge > 0) return runMerge(o, gen, P, W, H, writeChunk);
+
+    // Hors memoire : chaque chunk est ecrit des sa fenetre finie (ou jete en
+    // --bench) ; pic memoire fixe par le budget, pas par la taille du monde
+    if(o.memBudgetMB > 0){
+        gen.setWarpCacheBudget(0);
+        const size_t budget = (size_t)o.memBudgetMB << 20;
+        const size_t per = TerrainGenerator::outOfCoreChunkBytes(W, H, P);
+        std::printf("hors memoire : %.1f Mo par chunk, fenetre de %zu chunk(s)%s\n",
+                    per / 1048576.0, std::max<size_t>(1, std::min<size_t>(budget / per, (size_t)total)),
+                    P.seamless ? ", 2 passes (raccord)" : "");
+        double best = 1e30;
+        int written = 0;
+        for(int run=0;run<o.runs;run++){
+            written = 0;
+            const auto t0 = std::chrono::steady_clock::now();
+            const bool ok = gen.generateOutOfCore(W, H, P, budget, [&](int c, int r, const std::vector<float>& h){
+                if(o.bench) return true;
+                if(!writeChunk(c, r, h)){
+                    std::fprintf(stderr, "ecriture impossible : chunk r%d c%d\n", r, c);
+                    return false;
+                }
+                written++;
+                return true;
+            });
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            if(!ok) return 1;
+            if(ms < best) best = ms;
+            if(o.bench) std::printf("run %d : %.1f ms (%.1f Mpx/s)\n", run, ms, mpx / (ms * 1e-3));
+        }
+        if(o.bench) std::printf("meilleur : %.1f ms (%.1f Mpx/s)\n", best, mpx / (best * 1e-3));
+        else std::printf("Export %s chunks: %d/%d (%.1f ms, generation + ecriture)\n",
+                         o.format.c_str(), written, total, best);
+        return 0;
+    }
+
+    ChunkGrid grid;
+    grid.setHugePages(o.hugePages);
+    double best = 1e30;
+    for(int r=0;r<o.runs;r++){
+        const auto t0 = std::chrono::steady_clock::now();
+        gen.generateChunkGrid(grid, W, H, P);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        if(ms < best) best = ms;
+        if(o.bench) std::printf("run %d : %.1f ms (%.1f Mpx/s)\n", r, ms, mpx / (ms * 1e-3));
+    }
+    if(o.bench){
+        std::printf("meilleur : %.1f ms (%.1f Mpx/s), grille %.1f Mo%s\n", best, mpx / (best * 1e-3),
+                    grid.bytes() / (1024.0 * 1024.0), grid.quantized() ? " (16 bits)" : "");
+        // Transport eolien seul, sur une copie du chunk 0 (deja genere)
+        if(Aeolian::active(P)){
+            std::vector<float> h((size_t)W * H);
+            const ConstChunkView v = grid.chunk(0);
+            for(int y=0;y<H;y++)
+                for(int x=0;x<W;x++) h[(size_t)y*W + x] = v.at(x, y);
+            const int n = P.threadCount > 0 ? P.threadCount : ThreadPool::defaultThreadCount();
+            std::unique_ptr<ThreadPool> pool(n > 1 ? new ThreadPool(n) : nullptr);
+            const auto t0 = std::chrono::steady_clock::now();
+            Aeolian::run(h.data(), (size_t)W, W, H, P.terrainWidth / (W - 1), P.terrainLength / (H - 1), P, 1,
+                         [&](int k, const std::function<void(int)>& fn){
+                             if(pool) pool->parallelFor(k, fn);
+                             else for(int i=0;i<k;i++) fn(i);
+                         });
+            const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            std::printf("eolien : %d iterations sur %dx%d en %.2f s (%.1f it/s, %.1f Mevt/s)\n",
+                        P.aeolianIterations, W, H, s, P.aeolianIterations / s,
+                        (double)P.aeolianIterations * W * H * 1e-6 / s);
+        }
+        return 0;
+    }
+
+    int okCount = 0;
+    for(int r=0;r<grid.rows;r++)
+        for(int c=0;c<grid.cols;c++)
+            okCount += writeView(c, r, grid.mipView(ChunkGrid::index(c, r, grid.cols), o.mip));
+    std::printf("Export %s chunks: %d/%d (%.1f ms)\n", o.format.c_str(), okCount, total, best);
+    return okCount == total ? 0 : 1;
+}